@@ -2,6 +2,9 @@
 // required UE headers
 #include "CommandLineGeometryTest.h"
 #include "RequiredProgramMainCPPInclude.h"
+#include "Misc/Parse.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
 
 // GeometricObjects types for vector math, point sets, etc
 #include "VectorTypes.h"
@@ -48,6 +51,7 @@
 // Mesh I/O  (local to this project, not part of GeometryProcessing)
 #include "DynamicMeshOBJReader.h"
 #include "DynamicMeshOBJWriter.h"
+#include "StreamingMeshSimplifier.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogGeometryTest, Log, All);
 IMPLEMENT_APPLICATION(CommandLineGeometryTest, "CommandLineGeometryTest");
@@ -58,6 +62,34 @@ INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
 {
 	GEngineLoop.PreInit(ArgC, ArgV);
 
+	// batch mode: out-of-core simplification of a large OBJ file, eg
+	//    CommandLineGeometryTest -simplify=Scan.obj -output=Scan_50k.obj -tricount=50000 -membudget=2048
+	// the memory budget is in megabytes and bounds the memory used before the final QEM pass
+	FString SimplifyInputPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-simplify="), SimplifyInputPath))
+	{
+		FString SimplifyOutputPath = FPaths::Combine(FPaths::GetPath(SimplifyInputPath), FPaths::GetBaseFilename(SimplifyInputPath) + TEXT("_simplified.obj"));
+		FParse::Value(FCommandLine::Get(), TEXT("-output="), SimplifyOutputPath);
+		int32 TargetTriCount = 50000;
+		FParse::Value(FCommandLine::Get(), TEXT("-tricount="), TargetTriCount);
+		int32 MemoryBudgetMB = 1024;
+		FParse::Value(FCommandLine::Get(), TEXT("-membudget="), MemoryBudgetMB);
+
+		FStreamingMeshSimplifier StreamingSimplifier;
+		StreamingSimplifier.TargetTriangleCount = FMath::Max(4, TargetTriCount);
+		StreamingSimplifier.MemoryBudgetBytes = (int64)FMath::Max(1, MemoryBudgetMB) * 1024 * 1024;
+		FDynamicMesh3 SimplifiedMesh;
+		if (StreamingSimplifier.Simplify(TCHAR_TO_ANSI(*SimplifyInputPath), SimplifiedMesh) == false)
+		{
+			UE_LOG(LogGeometryTest, Display, TEXT("Streaming simplification of %s failed"), *SimplifyInputPath);
+			return 1;
+		}
+		UE_LOG(LogGeometryTest, Display, TEXT("Simplified mesh has %d vertices, %d triangles"), SimplifiedMesh.VertexCount(), SimplifiedMesh.TriangleCount());
+
+		FDynamicMeshOBJWriter::Write(TCHAR_TO_ANSI(*SimplifyOutputPath), { SimplifiedMesh }, false);
+		return 0;
+	}
+
 	// import an OBJ mesh. The path below is relative to the default path that Visual Studio will execute CommandLineGeometryTest.exe,
 	// when using a normal UE4.26 auto-generated UE.sln file. If things change you might need to update this path
 	FDynamicMesh3 ImportMesh;
@@ -0,0 +1,419 @@
+#pragma once
+
+#include "DynamicMesh3.h"
+#include "MeshSimplification.h"
+
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+
+/**
+ * Out-of-core simplification of OBJ meshes that are too large to load into an FDynamicMesh3.
+ *
+ * The OBJ file is streamed twice. The first pass only finds the bounds and the vertex count. The second pass clusters the vertices
+ * on a uniform grid, accumulates the error quadric of each triangle into the clusters of its corners, and keeps the triangles
+ * that connect three different clusters (ie vertex clustering with quadrics). The clustered mesh is then reduced to the final
+ * triangle count with FQEMSimplification.
+ *
+ * Memory use is bounded by MemoryBudgetBytes. Vertex positions are stored quantized to 16 bits per axis (6 bytes per vertex),
+ * which is far below the size of a cluster. The remaining budget determines the maximum number of clusters, and if the grid
+ * produces more clusters than that, its resolution is halved on the fly by merging the clusters of neighbouring cells.
+ */
+class FStreamingMeshSimplifier
+{
+public:
+
+	/** maximum memory used for the vertices, clusters and clustered triangles, in bytes */
+	int64 MemoryBudgetBytes = 1024ll * 1024ll * 1024ll;
+
+	/** triangle count of the final mesh */
+	int32 TargetTriangleCount = 50000;
+
+	/** the clustering grid is sized for this multiple of TargetTriangleCount, so that the final QEM pass has enough detail to work with */
+	int32 IntermediateTriangleFactor = 8;
+
+
+	bool Simplify(const char* Path, FDynamicMesh3& MeshOut)
+	{
+		if (!ScanBounds(Path))
+		{
+			UE_LOG(LogTemp, Display, TEXT("Could not read mesh from %s"), ANSI_TO_TCHAR(Path));
+			return false;
+		}
+
+		int64 VertexBytes = NumVertices * 3 * (int64)sizeof(uint16);
+		MaxClusters = (MemoryBudgetBytes - VertexBytes) / BytesPerCluster;
+		if (MaxClusters < (int64)TargetTriangleCount)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Memory budget of %lld MB is too small for %lld vertices and %d target triangles"),
+				MemoryBudgetBytes / (1024 * 1024), NumVertices, TargetTriangleCount);
+			return false;
+		}
+
+		// a surface crossing a grid of Resolution^3 cells touches roughly 3*Resolution^2 of them
+		int64 DesiredClusters = FMath::Min(MaxClusters, (int64)IntermediateTriangleFactor * (int64)TargetTriangleCount / 2);
+		Resolution = FMath::Clamp((int32)FMathd::Sqrt((double)DesiredClusters / 3.0), 2, 1 << 20);
+
+		if (!ClusterVertices(Path))
+		{
+			return false;
+		}
+		UE_LOG(LogTemp, Display, TEXT("Clustered %lld vertices into %d clusters and %d triangles, at grid resolution %d"),
+			NumVertices, Clusters.Num(), Triangles.Num(), Resolution);
+
+		BuildClusteredMesh(MeshOut);
+
+		// free the clustering data before the final pass
+		Clusters.Empty();
+		CellToCluster.Empty();
+		Triangles.Empty();
+		QuantizedVertices.Empty();
+
+		if (MeshOut.TriangleCount() > TargetTriangleCount)
+		{
+			FQEMSimplification Simplifier(&MeshOut);
+			Simplifier.SimplifyToTriangleCount(TargetTriangleCount);
+		}
+		return true;
+	}
+
+
+protected:
+
+	/** error quadric Q(x) = x^T A x + 2 b^T x + c, with the symmetric matrix A stored as xx, xy, xz, yy, yz, zz */
+	struct FQuadric
+	{
+		double A[6] = { 0, 0, 0, 0, 0, 0 };
+		double B[3] = { 0, 0, 0 };
+		double C = 0;
+
+		void AddPlane(const FVector3d& Normal, double D, double Weight)
+		{
+			A[0] += Weight * Normal.X * Normal.X;	A[1] += Weight * Normal.X * Normal.Y;	A[2] += Weight * Normal.X * Normal.Z;
+			A[3] += Weight * Normal.Y * Normal.Y;	A[4] += Weight * Normal.Y * Normal.Z;	A[5] += Weight * Normal.Z * Normal.Z;
+			B[0] += Weight * D * Normal.X;	B[1] += Weight * D * Normal.Y;	B[2] += Weight * D * Normal.Z;
+			C += Weight * D * D;
+		}
+
+		void Add(const FQuadric& Other)
+		{
+			for (int32 j = 0; j < 6; ++j)
+			{
+				A[j] += Other.A[j];
+			}
+			for (int32 j = 0; j < 3; ++j)
+			{
+				B[j] += Other.B[j];
+			}
+			C += Other.C;
+		}
+
+		/** solve A x = -b with Cramer's rule, returns false if A is (nearly) singular */
+		bool Minimize(FVector3d& PositionOut) const
+		{
+			double a = A[0], b = A[1], c = A[2], d = A[3], e = A[4], f = A[5];
+			double Det = a * (d * f - e * e) - b * (b * f - c * e) + c * (b * e - c * d);
+			double Scale = (a + d + f) / 3.0;
+			if (FMathd::Abs(Det) < 1e-6 * Scale * Scale * Scale || Scale <= 0)
+			{
+				return false;
+			}
+			double rx = -B[0], ry = -B[1], rz = -B[2];
+			PositionOut.X = (rx * (d * f - e * e) - b * (ry * f - e * rz) + c * (ry * e - d * rz)) / Det;
+			PositionOut.Y = (a * (ry * f - e * rz) - rx * (b * f - c * e) + c * (b * rz - ry * c)) / Det;
+			PositionOut.Z = (a * (d * rz - ry * e) - b * (b * rz - ry * c) + rx * (b * e - c * d)) / Det;
+			return true;
+		}
+	};
+
+	struct FCluster
+	{
+		FQuadric Quadric;
+		FVector3d PositionSum = FVector3d::Zero();
+		int32 Count = 0;
+	};
+
+	// estimate of the memory for one cluster, its map entry, and the ~2 clustered triangles per cluster
+	static constexpr int64 BytesPerCluster = sizeof(FCluster) + 32 + 2 * (sizeof(FIndex3i) + 16);
+
+	FAxisAlignedBox3d Bounds;
+	int64 NumVertices = 0;
+	int64 MaxClusters = 0;
+	int32 Resolution = 2;
+	double CellSize = 1.0;
+
+	TArray<uint16> QuantizedVertices;
+	TMap<int64, int32> CellToCluster;
+	TArray<FCluster> Clusters;
+	TSet<FIndex3i> Triangles;
+
+
+	/** first pass, find bounds and vertex count */
+	bool ScanBounds(const char* Path)
+	{
+		std::ifstream FileIn(Path);
+		if (!FileIn)
+		{
+			return false;
+		}
+		Bounds = FAxisAlignedBox3d::Empty();
+		NumVertices = 0;
+		std::string Line;
+		while (std::getline(FileIn, Line))
+		{
+			if (Line.size() > 2 && Line[0] == 'v' && Line[1] == ' ')
+			{
+				Bounds.Contain(ParseVertex(Line));
+				NumVertices++;
+			}
+		}
+		return NumVertices > 0;
+	}
+
+
+	/** second pass, quantize the vertices and accumulate the clusters and clustered triangles */
+	bool ClusterVertices(const char* Path)
+	{
+		std::ifstream FileIn(Path);
+		if (!FileIn)
+		{
+			return false;
+		}
+		CellSize = FMathd::Max(Bounds.MaxDim(), FMathf::ZeroTolerance) / (double)Resolution;
+		QuantizedVertices.Reserve(NumVertices * 3);
+
+		std::string Line;
+		TArray<int32> FaceVertices;
+		while (std::getline(FileIn, Line))
+		{
+			if (Line.size() > 2 && Line[0] == 'v' && Line[1] == ' ')
+			{
+				FVector3d Position = ParseVertex(Line);
+				for (int32 j = 0; j < 3; ++j)
+				{
+					double Extent = FMathd::Max(Bounds.Max[j] - Bounds.Min[j], FMathf::ZeroTolerance);
+					QuantizedVertices.Add((uint16)FMath::Clamp((int32)FMathd::Round(65535.0 * (Position[j] - Bounds.Min[j]) / Extent), 0, 65535));
+				}
+				int32 VertexIndex = QuantizedVertices.Num() / 3 - 1;
+				FCluster& Cluster = Clusters[FindOrAddCluster(GetVertex(VertexIndex))];
+				Cluster.PositionSum += GetVertex(VertexIndex);
+				Cluster.Count++;
+			}
+			else if (Line.size() > 2 && Line[0] == 'f' && Line[1] == ' ')
+			{
+				ParseFace(Line, FaceVertices);
+				for (int32 k = 1; k + 1 < FaceVertices.Num(); ++k)
+				{
+					AddTriangle(FaceVertices[0], FaceVertices[k], FaceVertices[k + 1]);
+				}
+			}
+			else
+			{
+				continue;
+			}
+
+			if ((int64)Clusters.Num() > MaxClusters || (int64)Triangles.Num() > 2 * MaxClusters)
+			{
+				Coarsen();
+			}
+		}
+		return true;
+	}
+
+
+	FVector3d GetVertex(int32 VertexIndex) const
+	{
+		FVector3d Position;
+		for (int32 j = 0; j < 3; ++j)
+		{
+			Position[j] = Bounds.Min[j] + (Bounds.Max[j] - Bounds.Min[j]) * ((double)QuantizedVertices[3 * VertexIndex + j] / 65535.0);
+		}
+		return Position;
+	}
+
+	int64 GetCellKey(const FVector3d& Position) const
+	{
+		int64 Cell[3];
+		for (int32 j = 0; j < 3; ++j)
+		{
+			Cell[j] = FMath::Clamp((int64)((Position[j] - Bounds.Min[j]) / CellSize), (int64)0, (int64)Resolution - 1);
+		}
+		return Cell[0] + (int64)Resolution * (Cell[1] + (int64)Resolution * Cell[2]);
+	}
+
+	int32 FindOrAddCluster(const FVector3d& Position)
+	{
+		int64 Key = GetCellKey(Position);
+		const int32* Found = CellToCluster.Find(Key);
+		if (Found != nullptr)
+		{
+			return *Found;
+		}
+		int32 NewIndex = Clusters.AddDefaulted();
+		CellToCluster.Add(Key, NewIndex);
+		return NewIndex;
+	}
+
+	/** @return triangle rotated so that the smallest index is first, which preserves orientation */
+	static FIndex3i CanonicalTriangle(int32 A, int32 B, int32 C)
+	{
+		if (A < B && A < C)
+		{
+			return FIndex3i(A, B, C);
+		}
+		return (B < C) ? FIndex3i(B, C, A) : FIndex3i(C, A, B);
+	}
+
+	void AddTriangle(int32 V0, int32 V1, int32 V2)
+	{
+		int32 NumRead = QuantizedVertices.Num() / 3;
+		if (V0 < 0 || V1 < 0 || V2 < 0 || V0 >= NumRead || V1 >= NumRead || V2 >= NumRead)
+		{
+			return;
+		}
+
+		FVector3d P0 = GetVertex(V0), P1 = GetVertex(V1), P2 = GetVertex(V2);
+		FVector3d Normal = (P1 - P0).Cross(P2 - P0);
+		double DoubleArea = Normal.Length();
+		int32 ClusterIDs[3] = { FindOrAddCluster(P0), FindOrAddCluster(P1), FindOrAddCluster(P2) };
+		if (DoubleArea > FMathd::ZeroTolerance)
+		{
+			Normal /= DoubleArea;
+			double D = -Normal.Dot(P0);
+			for (int32 j = 0; j < 3; ++j)
+			{
+				Clusters[ClusterIDs[j]].Quadric.AddPlane(Normal, D, 0.5 * DoubleArea);
+			}
+		}
+
+		if (ClusterIDs[0] != ClusterIDs[1] && ClusterIDs[1] != ClusterIDs[2] && ClusterIDs[2] != ClusterIDs[0])
+		{
+			Triangles.Add(CanonicalTriangle(ClusterIDs[0], ClusterIDs[1], ClusterIDs[2]));
+		}
+	}
+
+
+	/** halve the grid resolution, merging the clusters of each 2x2x2 block of cells */
+	void Coarsen()
+	{
+		// the new cells must be exactly the 2x2x2 blocks of old cells, so that vertices read later land in the same cluster as
+		// the merged cells. With an odd resolution, the last block of each axis only partially overlaps the bounds.
+		int64 OldResolution = Resolution;
+		Resolution = FMath::Max(1, (Resolution + 1) / 2);
+		CellSize *= 2.0;
+
+		TMap<int64, int32> NewCellToCluster;
+		TArray<FCluster> NewClusters;
+		TArray<int32> ClusterMap;
+		ClusterMap.SetNum(Clusters.Num());
+		for (const TPair<int64, int32>& Pair : CellToCluster)
+		{
+			int64 X = Pair.Key % OldResolution, Y = (Pair.Key / OldResolution) % OldResolution, Z = Pair.Key / (OldResolution * OldResolution);
+			int64 NewKey = (X / 2) + (int64)Resolution * ((Y / 2) + (int64)Resolution * (Z / 2));
+			const int32* Found = NewCellToCluster.Find(NewKey);
+			int32 NewIndex = (Found != nullptr) ? *Found : NewClusters.AddDefaulted();
+			if (Found == nullptr)
+			{
+				NewCellToCluster.Add(NewKey, NewIndex);
+			}
+			const FCluster& OldCluster = Clusters[Pair.Value];
+			NewClusters[NewIndex].Quadric.Add(OldCluster.Quadric);
+			NewClusters[NewIndex].PositionSum += OldCluster.PositionSum;
+			NewClusters[NewIndex].Count += OldCluster.Count;
+			ClusterMap[Pair.Value] = NewIndex;
+		}
+
+		TSet<FIndex3i> NewTriangles;
+		for (const FIndex3i& Tri : Triangles)
+		{
+			int32 A = ClusterMap[Tri.A], B = ClusterMap[Tri.B], C = ClusterMap[Tri.C];
+			if (A != B && B != C && C != A)
+			{
+				NewTriangles.Add(CanonicalTriangle(A, B, C));
+			}
+		}
+
+		CellToCluster = MoveTemp(NewCellToCluster);
+		Clusters = MoveTemp(NewClusters);
+		Triangles = MoveTemp(NewTriangles);
+	}
+
+
+	/** place each cluster vertex at the minimizer of its quadric if that lies in (or near) its cell, otherwise at the mean of its vertices */
+	void BuildClusteredMesh(FDynamicMesh3& MeshOut)
+	{
+		TArray<int32> ClusterToVertex;
+		ClusterToVertex.Init(-1, Clusters.Num());
+		for (const TPair<int64, int32>& Pair : CellToCluster)
+		{
+			const FCluster& Cluster = Clusters[Pair.Value];
+			if (Cluster.Count == 0)
+			{
+				continue;
+			}
+			FVector3d Mean = Cluster.PositionSum / (double)Cluster.Count;
+			FVector3d Position;
+			if (Cluster.Quadric.Minimize(Position) == false || Position.Distance(Mean) > CellSize)
+			{
+				Position = Mean;
+			}
+			ClusterToVertex[Pair.Value] = MeshOut.AppendVertex(Position);
+		}
+
+		for (const FIndex3i& Tri : Triangles)
+		{
+			int32 A = ClusterToVertex[Tri.A], B = ClusterToVertex[Tri.B], C = ClusterToVertex[Tri.C];
+			if (A >= 0 && B >= 0 && C >= 0)
+			{
+				MeshOut.AppendTriangle(A, B, C);		// non-manifold triangles are skipped
+			}
+		}
+	}
+
+
+	static FVector3d ParseVertex(const std::string& Line)
+	{
+		const char* Cur = Line.c_str() + 2;
+		char* End = nullptr;
+		FVector3d Position;
+		for (int32 j = 0; j < 3; ++j)
+		{
+			Position[j] = std::strtod(Cur, &End);
+			Cur = End;
+		}
+		return Position;
+	}
+
+	/** parse the vertex indices of a face line, with any of the v, v/vt, v//vn, v/vt/vn forms, and negative (relative) indices */
+	void ParseFace(const std::string& Line, TArray<int32>& FaceVerticesOut) const
+	{
+		FaceVerticesOut.Reset();
+		int32 NumRead = QuantizedVertices.Num() / 3;
+		const char* Cur = Line.c_str() + 2;
+		while (*Cur != '\0')
+		{
+			while (*Cur == ' ' || *Cur == '\t' || *Cur == '\r')
+			{
+				Cur++;
+			}
+			if (*Cur == '\0')
+			{
+				break;
+			}
+			char* End = nullptr;
+			long Index = std::strtol(Cur, &End, 10);
+			if (End == Cur)
+			{
+				break;
+			}
+			FaceVerticesOut.Add((Index > 0) ? (int32)(Index - 1) : (NumRead + (int32)Index));
+			// skip texcoord/normal indices
+			Cur = End;
+			while (*Cur != '\0' && *Cur != ' ' && *Cur != '\t')
+			{
+				Cur++;
+			}
+		}
+	}
+};
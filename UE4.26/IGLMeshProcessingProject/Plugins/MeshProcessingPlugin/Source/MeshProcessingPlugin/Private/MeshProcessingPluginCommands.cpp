@@ -11,6 +11,9 @@ void FMeshProcessingPluginCommands::RegisterCommands()
 	// The First quoted string is the label that will appear in the toolbar button, and the second is the tooltip.
 
 	UI_COMMAND(BeginIGLSmoothingTool, "IGLSmooth", "Start the LibIGL Mesh Smoothing Tool", EUserInterfaceActionType::Button, FInputChord());
+	UI_COMMAND(BeginIGLGeodesicsTool, "IGLGeodesics", "Start the LibIGL Heat Geodesics Tool", EUserInterfaceActionType::Button, FInputChord());
+	UI_COMMAND(BeginIGLARAPTool, "IGLARAP", "Start the LibIGL As-Rigid-As-Possible Deformation Tool", EUserInterfaceActionType::Button, FInputChord());
+	UI_COMMAND(BeginIGLUVUnwrapTool, "IGLUVUnwrap", "Start the LibIGL Conformal UV Unwrap Tool", EUserInterfaceActionType::Button, FInputChord());
 	UI_COMMAND(BeginMeshExportTool, "Export", "Start the Mesh Export Tool", EUserInterfaceActionType::Button, FInputChord());
 
 	UI_COMMAND(AcceptActiveTool, "Accept", "Accept the active tool", EUserInterfaceActionType::Button, FInputChord());
@@ -9,6 +9,9 @@
 // include the header files for your various Tools here
 //
 #include "Tools/IGLSmoothingTool.h"
+#include "Tools/IGLGeodesicsTool.h"
+#include "Tools/IGLARAPTool.h"
+#include "Tools/IGLUVUnwrapTool.h"
 #include "Tools/MeshExportTool.h"
 
 
@@ -36,6 +39,9 @@ void FMeshProcessingPluginEdMode::RegisterModeTools()
 	//
 
 	RegisterToolFunc(PluginCommands.BeginIGLSmoothingTool, TEXT("IGLSmoothTool"), NewObject<UIGLSmoothingToolBuilder>());
+	RegisterToolFunc(PluginCommands.BeginIGLGeodesicsTool, TEXT("IGLGeodesicsTool"), NewObject<UIGLGeodesicsToolBuilder>());
+	RegisterToolFunc(PluginCommands.BeginIGLARAPTool, TEXT("IGLARAPTool"), NewObject<UIGLARAPToolBuilder>());
+	RegisterToolFunc(PluginCommands.BeginIGLUVUnwrapTool, TEXT("IGLUVUnwrapTool"), NewObject<UIGLUVUnwrapToolBuilder>());
 
 	RegisterToolFunc(PluginCommands.BeginMeshExportTool, TEXT("Export Mesh"), NewObject<UMeshExportToolBuilder>());
 }
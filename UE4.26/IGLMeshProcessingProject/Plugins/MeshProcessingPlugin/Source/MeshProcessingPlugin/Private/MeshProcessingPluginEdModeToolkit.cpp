@@ -34,6 +34,9 @@ void FMeshProcessingPluginEdModeToolkit::BuildToolPalette(FName PaletteIndex, cl
 	ToolbarBuilder.AddSeparator();
 
 	ToolbarBuilder.AddToolBarButton(Commands.BeginIGLSmoothingTool);
+	ToolbarBuilder.AddToolBarButton(Commands.BeginIGLGeodesicsTool);
+	ToolbarBuilder.AddToolBarButton(Commands.BeginIGLARAPTool);
+	ToolbarBuilder.AddToolBarButton(Commands.BeginIGLUVUnwrapTool);
 	ToolbarBuilder.AddToolBarButton(Commands.BeginMeshExportTool);
 }
 
@@ -0,0 +1,177 @@
+#pragma once
+#include "IGLIncludes.h"
+#include "IGLSolverUtil.h"
+#include "Async/ParallelFor.h"
+#include "Util/ProgressCancel.h"
+
+//
+// As-Rigid-As-Possible deformation [Sorkine and Alexa 2007] with cotangent weights, for interactive editing.
+// The matrix of the global step only depends on the rest mesh and on which vertices are constrained, so it is factorized once
+// for a constraint set, and each update of the constrained positions only runs local/global iterations, ie parallel 3x3 rotation fits
+// and a back-substitution. This is the algorithm of igl::arap, which cannot be used directly because igl::min_quad_with_fixed
+// needs the unsupported Eigen modules.
+//
+
+namespace iglext
+{
+	class FARAPSolver
+	{
+	public:
+		/**
+		 * Precompute the solver for the rest positions RestV and cotangent Laplacian L (eg from igl::cotmatrix) of a mesh
+		 * @param ConstrainedRowsIn sorted list of the rows of the constrained vertices
+		 * @return false if the factorization failed (eg if no vertex is constrained)
+		 */
+		bool Setup(const Eigen::MatrixXd& RestVIn, const Eigen::SparseMatrix<double>& L, const TArray<int32>& ConstrainedRowsIn)
+		{
+			RestV = RestVIn;
+			ConstrainedRows = ConstrainedRowsIn;
+			int32 NumVertices = (int32)RestV.rows();
+			if (ConstrainedRows.Num() == 0)
+			{
+				return false;
+			}
+
+			RowToFree.Init(-1, NumVertices);
+			TArray<int32> RowToConstrained;
+			RowToConstrained.Init(-1, NumVertices);
+			for (int32 k = 0; k < ConstrainedRows.Num(); ++k)
+			{
+				RowToConstrained[ConstrainedRows[k]] = k;
+			}
+			FreeRows.Reset();
+			for (int32 Row = 0; Row < NumVertices; ++Row)
+			{
+				if (RowToConstrained[Row] < 0)
+				{
+					RowToFree[Row] = FreeRows.Num();
+					FreeRows.Add(Row);
+				}
+			}
+
+			// edge weights for the local step, and the blocks of K = -L for the free rows
+			Weights = FRowMajorSparseMatrix(L);
+			TArray<Eigen::Triplet<double>> FreeEntries, ConstrainedEntries;
+			for (int32 Row = 0; Row < NumVertices; ++Row)
+			{
+				int32 FreeRow = RowToFree[Row];
+				if (FreeRow < 0)
+				{
+					continue;
+				}
+				for (FRowMajorSparseMatrix::InnerIterator It(Weights, Row); It; ++It)
+				{
+					int32 Col = (int32)It.col();
+					if (RowToFree[Col] >= 0)
+					{
+						FreeEntries.Add(Eigen::Triplet<double>(FreeRow, RowToFree[Col], -It.value()));
+					}
+					else
+					{
+						ConstrainedEntries.Add(Eigen::Triplet<double>(FreeRow, RowToConstrained[Col], -It.value()));
+					}
+				}
+			}
+			Eigen::SparseMatrix<double> KFF(FreeRows.Num(), FreeRows.Num());
+			KFF.setFromTriplets(FreeEntries.GetData(), FreeEntries.GetData() + FreeEntries.Num());
+			KFC = Eigen::SparseMatrix<double>(FreeRows.Num(), ConstrainedRows.Num());
+			KFC.setFromTriplets(ConstrainedEntries.GetData(), ConstrainedEntries.GetData() + ConstrainedEntries.Num());
+
+			if (FreeRows.Num() > 0)
+			{
+				FreeSolver.compute(KFF);
+				if (FreeSolver.info() != Eigen::Success)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/** @return the constrained rows passed to Setup() */
+		const TArray<int32>& GetConstrainedRows() const
+		{
+			return ConstrainedRows;
+		}
+
+		/**
+		 * Run local/global iterations. Only reads the precomputed data, so it can be called from several threads at once.
+		 * @param ConstrainedPositions positions of the constrained vertices, in the order of the constrained rows
+		 * @param U initial guess for the deformed positions (eg the result for the previous constraint positions), replaced with the result
+		 */
+		void Solve(const Eigen::MatrixXd& ConstrainedPositions, int32 Iterations, Eigen::MatrixXd& U, FProgressCancel* Progress = nullptr) const
+		{
+			int32 NumVertices = (int32)RestV.rows();
+			for (int32 k = 0; k < ConstrainedRows.Num(); ++k)
+			{
+				U.row(ConstrainedRows[k]) = ConstrainedPositions.row(k);
+			}
+
+			TArray<Eigen::Matrix3d> Rotations;
+			Rotations.SetNum(NumVertices);
+			Eigen::MatrixXd RHS(FreeRows.Num(), 3);
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				if (Progress && Progress->Cancelled())
+				{
+					return;
+				}
+
+				// local step: best rotation of the one-ring of each vertex, from the polar decomposition of the edge covariance
+				ParallelForRows(NumVertices, [&](int32 Row)
+				{
+					Eigen::Matrix3d Covariance = Eigen::Matrix3d::Zero();
+					for (FRowMajorSparseMatrix::InnerIterator It(Weights, Row); It; ++It)
+					{
+						if (It.col() != Row)
+						{
+							Eigen::Vector3d RestEdge = (RestV.row(Row) - RestV.row(It.col())).transpose();
+							Eigen::Vector3d Edge = (U.row(Row) - U.row(It.col())).transpose();
+							Covariance += It.value() * Edge * RestEdge.transpose();
+						}
+					}
+					igl::polar_svd3x3(Covariance, Rotations[Row]);
+				});
+
+				// global step: positions of the free vertices that best match the rotated rest edges
+				ParallelForRows(FreeRows.Num(), [&](int32 FreeRow)
+				{
+					int32 Row = FreeRows[FreeRow];
+					Eigen::Vector3d Sum = Eigen::Vector3d::Zero();
+					for (FRowMajorSparseMatrix::InnerIterator It(Weights, Row); It; ++It)
+					{
+						if (It.col() != Row)
+						{
+							Eigen::Vector3d RestEdge = (RestV.row(Row) - RestV.row(It.col())).transpose();
+							Sum += 0.5 * It.value() * (Rotations[Row] + Rotations[(int32)It.col()]) * RestEdge;
+						}
+					}
+					RHS.row(FreeRow) = Sum.transpose();
+				});
+				if (FreeRows.Num() > 0)
+				{
+					RHS -= KFC * ConstrainedPositions;
+					Eigen::MatrixXd FreePositions = FreeSolver.solve(RHS);
+					ParallelForRows(FreeRows.Num(), [&](int32 FreeRow)
+					{
+						U.row(FreeRows[FreeRow]) = FreePositions.row(FreeRow);
+					});
+				}
+			}
+		}
+
+	protected:
+		Eigen::MatrixXd RestV;
+		// cotangent weights, row-major for the one-ring gathers
+		FRowMajorSparseMatrix Weights;
+
+		TArray<int32> ConstrainedRows;
+		TArray<int32> FreeRows;
+		// row -> index in FreeRows, or -1 for constrained rows
+		TArray<int32> RowToFree;
+
+		// blocks of K = -L with the free rows, for the free and the constrained columns
+		Eigen::SparseMatrix<double> KFC;
+		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> FreeSolver;
+	};
+}
@@ -0,0 +1,198 @@
+#include "Tools/IGLARAPTool.h"
+#include "Tools/IGLIncludes.h"		// include this before your igl includes (or add them to the list there)
+#include "Tools/IGLUtil.h"
+#include "Tools/IGLARAPSolver.h"
+#include "Misc/ScopeLock.h"
+
+
+#define LOCTEXT_NAMESPACE "UIGLARAPTool"
+
+
+/**
+ * Data for UIGLARAPTool that only depends on the input mesh and the constraint set. It is built by the first background computation
+ * and then reused by the following ones.
+ */
+struct FIGLARAPCache
+{
+	FCriticalSection BuildLock;
+	bool bBuilt = false;
+
+	// input mesh in libigl representation, IndexMap maps it to the (possibly non-compact) input mesh
+	iglext::FIGLMeshIndexMap IndexMap;
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi F;
+	// cotangent Laplacian of the input mesh
+	Eigen::SparseMatrix<double> L;
+	double MeshSize = 1.0;
+
+	// solver for the most recently used set of constrained vertices. It is replaced (not modified) when the set changes,
+	// so computations that still use the previous one are not affected.
+	FCriticalSection SolverLock;
+	TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe> Solver;
+
+	// most recent result, and the solver it was computed with, used as initial guess by the next computation
+	FCriticalSection ResultLock;
+	TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe> ResultSolver;
+	Eigen::MatrixXd Result;
+
+	void Build(const FDynamicMesh3& Mesh)
+	{
+		FScopeLock Lock(&BuildLock);
+		if (bBuilt)
+		{
+			return;
+		}
+
+		IndexMap.Build(Mesh);
+		iglext::DynamicMeshToIGLMesh(Mesh, IndexMap, V, F);
+		igl::cotmatrix(V, F, L);
+		MeshSize = FMathd::Max(Mesh.GetBounds().MaxDim(), FMathd::ZeroTolerance);
+
+		bBuilt = true;
+	}
+
+	// @return solver for the sorted ConstrainedRows, or null if the factorization failed
+	TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe> GetSolver(const TArray<int32>& ConstrainedRows)
+	{
+		FScopeLock Lock(&SolverLock);
+		if (Solver.IsValid() == false || Solver->GetConstrainedRows() != ConstrainedRows)
+		{
+			TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe> NewSolver = MakeShared<iglext::FARAPSolver, ESPMode::ThreadSafe>();
+			if (NewSolver->Setup(V, L, ConstrainedRows) == false)
+			{
+				return nullptr;
+			}
+			Solver = NewSolver;
+		}
+		return Solver;
+	}
+
+	// @return the most recent result if it was computed with UseSolver, otherwise the rest positions
+	void GetInitialPositions(const TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe>& UseSolver, Eigen::MatrixXd& PositionsOut)
+	{
+		FScopeLock Lock(&ResultLock);
+		PositionsOut = (ResultSolver == UseSolver) ? Result : V;
+	}
+
+	void SetResult(const TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe>& UseSolver, const Eigen::MatrixXd& Positions)
+	{
+		FScopeLock Lock(&ResultLock);
+		ResultSolver = UseSolver;
+		Result = Positions;
+	}
+};
+
+
+
+void UIGLARAPTool::InitializeProperties()
+{
+	ARAPProperties = NewObject<UIGLARAPToolProperties>(this);
+	AddToolPropertySource(ARAPProperties);
+	ARAPProperties->RestoreProperties(this);
+	ARAPProperties->WatchProperty(ARAPProperties->FixedVertices, [&](const TArray<int>&) { InvalidateResult(); });
+	ARAPProperties->WatchProperty(ARAPProperties->HandleVertices, [&](const TArray<int>&) { InvalidateResult(); });
+	ARAPProperties->WatchProperty(ARAPProperties->HandleTranslation, [&](const FVector&) { InvalidateResult(); });
+	ARAPProperties->WatchProperty(ARAPProperties->Iterations, [&](int) { InvalidateResult(); });
+
+	UMeshProcessingTool::InitializeProperties();		// allow base class to add shared properties
+}
+
+
+void UIGLARAPTool::OnShutdown(EToolShutdownType ShutdownType)
+{
+	UMeshProcessingTool::OnShutdown(ShutdownType);
+	ARAPProperties->SaveProperties(this);
+}
+
+
+TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> UIGLARAPTool::MakeMeshProcessingFunction()
+{
+	// Do *not* use & capture or reference this class directly in the lambda constructed below.
+	// Make copies of values. Otherwise compute thread may reference changing values.
+	TArray<int> FixedVertices = ARAPProperties->FixedVertices;
+	TArray<int> HandleVertices = ARAPProperties->HandleVertices;
+	FVector3d HandleTranslation = ARAPProperties->HandleTranslation;
+	int Iterations = FMath::Max(ARAPProperties->Iterations, 1);
+
+	// the cache is shared with the lambda, it is only ever built from the (unchanging) input mesh
+	if (ARAPCache.IsValid() == false)
+	{
+		ARAPCache = MakeShared<FIGLARAPCache, ESPMode::ThreadSafe>();
+	}
+	TSharedPtr<FIGLARAPCache, ESPMode::ThreadSafe> Cache = ARAPCache;
+
+	// construct compute lambda
+	auto EditFunction = [FixedVertices, HandleVertices, HandleTranslation, Iterations, Cache](FDynamicMesh3& ResultMesh, FProgressCancel* Progress, FMeshProcessingResultInfo& ResultInfo)
+	{
+		// convert FDynamicMesh3 to igl mesh representation and compute the Laplacian, if not done yet
+		Cache->Build(ResultMesh);
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+		const iglext::FIGLMeshIndexMap& IndexMap = Cache->IndexMap;
+
+		// constrained rows, handles take precedence over fixed vertices
+		TMap<int32, bool> RowIsHandle;
+		for (int vid : FixedVertices)
+		{
+			if (ResultMesh.IsVertex(vid))
+			{
+				RowIsHandle.Add(IndexMap.GetVertexRow(vid), false);
+			}
+		}
+		for (int vid : HandleVertices)
+		{
+			if (ResultMesh.IsVertex(vid))
+			{
+				RowIsHandle.Add(IndexMap.GetVertexRow(vid), true);
+			}
+		}
+		if (RowIsHandle.Num() == 0)
+		{
+			return;		// nothing to do without constraints
+		}
+		TArray<int32> ConstrainedRows;
+		RowIsHandle.GenerateKeyArray(ConstrainedRows);
+		ConstrainedRows.Sort();
+
+		// factorize the global step for this constraint set, if not done yet
+		TSharedPtr<iglext::FARAPSolver, ESPMode::ThreadSafe> Solver = Cache->GetSolver(ConstrainedRows);
+		if (Solver.IsValid() == false || (Progress && Progress->Cancelled()))
+		{
+			return;
+		}
+
+		Eigen::RowVector3d Translation(HandleTranslation.X, HandleTranslation.Y, HandleTranslation.Z);
+		Translation *= Cache->MeshSize;
+		Eigen::MatrixXd ConstrainedPositions(ConstrainedRows.Num(), 3);
+		for (int32 k = 0; k < ConstrainedRows.Num(); ++k)
+		{
+			ConstrainedPositions.row(k) = Cache->V.row(ConstrainedRows[k]);
+			if (RowIsHandle[ConstrainedRows[k]])
+			{
+				ConstrainedPositions.row(k) += Translation;
+			}
+		}
+
+		// start from the previous result, so that dragging the handles continues to converge
+		Eigen::MatrixXd U;
+		Cache->GetInitialPositions(Solver, U);
+		Solver->Solve(ConstrainedPositions, Iterations, U, Progress);
+		if (Progress && Progress->Cancelled())
+		{
+			return;		// result will be discarded
+		}
+		Cache->SetResult(Solver, U);
+
+		iglext::SetVertexPositions(ResultMesh, IndexMap, U, &ResultInfo.ModifiedVertices);   // copy updated positions back to FDynamicMesh3
+
+		// fixed vertices, and free vertices far from the handles, do not move, so their normals do not have to be recomputed
+		ResultInfo.bOnlyModifiedListedVertices = true;
+	};
+
+	return MoveTemp(EditFunction);  // return compute lambda
+}
+
+
+#undef LOCTEXT_NAMESPACE
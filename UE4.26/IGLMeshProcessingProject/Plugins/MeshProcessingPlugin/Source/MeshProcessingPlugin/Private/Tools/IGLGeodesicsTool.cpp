@@ -0,0 +1,236 @@
+#include "Tools/IGLGeodesicsTool.h"
+#include "Tools/IGLIncludes.h"		// include this before your igl includes (or add them to the list there)
+#include "Tools/IGLUtil.h"
+#include "Tools/ParallelMeshNormals.h"
+#include "Misc/ScopeLock.h"
+
+
+#define LOCTEXT_NAMESPACE "UIGLGeodesicsTool"
+
+
+typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> FIGLGeodesicsSolver;
+
+/**
+ * Factorized Heat Method [Crane et al. 2013] systems for one time step. Solving only reads this data, so it can be used by several computations at once.
+ * This follows igl::heat_geodesics_precompute() (with Neumann boundary conditions only), which cannot be used directly because
+ * igl::min_quad_with_fixed needs the unsupported Eigen modules.
+ */
+struct FIGLHeatGeodesicsData
+{
+	double TimeStepScale = 1.0;
+	// factorization of (M - t*L) for the heat flow
+	FIGLGeodesicsSolver HeatSolver;
+	// factorization of (-L + epsilon*M) for the Poisson problem. L is singular, the small regularization makes it definite.
+	FIGLGeodesicsSolver PoissonSolver;
+};
+
+/**
+ * Data for UIGLGeodesicsTool that only depends on the input mesh (and the time step). It is built by the first background computation
+ * and then reused by all following ones.
+ */
+struct FIGLGeodesicsCache
+{
+	FCriticalSection BuildLock;
+	bool bBuilt = false;
+
+	// input mesh in libigl representation, IndexMap maps it to the (possibly non-compact) input mesh
+	iglext::FIGLMeshIndexMap IndexMap;
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi F;
+	// vertex normals of the input mesh, indexed by vertex ID
+	TArray<FVector3d> Normals;
+	double MeshSize = 1.0;
+	double MeanEdgeLength = 1.0;
+
+	// cotangent Laplacian and mass matrix
+	Eigen::SparseMatrix<double> L, M;
+	// gradient operator (3*#F by #V, x components of all faces first), and the transposed gradient weighted by face areas, which is the integrated divergence
+	Eigen::SparseMatrix<double> Grad, Div;
+
+	// precomputation for the most recently used time step. It is replaced (not modified) when the time step changes,
+	// so computations that still use the previous one are not affected.
+	FCriticalSection HeatDataLock;
+	TSharedPtr<FIGLHeatGeodesicsData, ESPMode::ThreadSafe> HeatData;
+
+	void Build(const FDynamicMesh3& Mesh)
+	{
+		FScopeLock Lock(&BuildLock);
+		if (bBuilt)
+		{
+			return;
+		}
+
+		IndexMap.Build(Mesh);
+		iglext::DynamicMeshToIGLMesh(Mesh, IndexMap, V, F);
+		MeshProcessingNormals::ComputeVertexNormals(Mesh, Normals);
+		MeshSize = FMathd::Max(Mesh.GetBounds().MaxDim(), FMathd::ZeroTolerance);
+		MeanEdgeLength = igl::avg_edge_length(V, F);
+
+		igl::cotmatrix(V, F, L);
+		igl::massmatrix(V, F, igl::MASSMATRIX_TYPE_DEFAULT, M);
+		igl::grad(V, F, Grad);
+		Eigen::VectorXd DoubleAreas;
+		igl::doublearea(V, F, DoubleAreas);
+		Eigen::VectorXd FaceAreas = (0.5 * DoubleAreas).replicate(3, 1);
+		Div = Grad.transpose() * FaceAreas.asDiagonal();
+
+		bBuilt = true;
+	}
+
+	// @return precomputation for TimeStepScale, or null if it failed
+	TSharedPtr<FIGLHeatGeodesicsData, ESPMode::ThreadSafe> GetHeatData(double TimeStepScale)
+	{
+		FScopeLock Lock(&HeatDataLock);
+		if (HeatData.IsValid() == false || HeatData->TimeStepScale != TimeStepScale)
+		{
+			TSharedPtr<FIGLHeatGeodesicsData, ESPMode::ThreadSafe> NewData = MakeShared<FIGLHeatGeodesicsData, ESPMode::ThreadSafe>();
+			NewData->TimeStepScale = TimeStepScale;
+			double TimeStep = TimeStepScale * MeanEdgeLength * MeanEdgeLength;
+			NewData->HeatSolver.compute(M - TimeStep * L);
+			if (NewData->HeatSolver.info() != Eigen::Success)
+			{
+				return nullptr;
+			}
+			double Epsilon = 1e-8 * (-L.diagonal().sum()) / FMathd::Max(M.diagonal().sum(), FMathd::ZeroTolerance);
+			NewData->PoissonSolver.compute(-L + Epsilon * M);
+			if (NewData->PoissonSolver.info() != Eigen::Success)
+			{
+				return nullptr;
+			}
+			HeatData = NewData;
+		}
+		return HeatData;
+	}
+};
+
+
+
+void UIGLGeodesicsTool::InitializeProperties()
+{
+	GeodesicsProperties = NewObject<UIGLGeodesicsToolProperties>(this);
+	AddToolPropertySource(GeodesicsProperties);
+	GeodesicsProperties->RestoreProperties(this);
+	GeodesicsProperties->WatchProperty(GeodesicsProperties->SourceVertices, [&](const TArray<int>&) { InvalidateResult(); });
+	GeodesicsProperties->WatchProperty(GeodesicsProperties->TimeStepScale, [&](float) { InvalidateResult(); });
+	GeodesicsProperties->WatchProperty(GeodesicsProperties->RippleWavelength, [&](float) { InvalidateResult(); });
+	GeodesicsProperties->WatchProperty(GeodesicsProperties->RippleAmplitude, [&](float) { InvalidateResult(); });
+
+	UMeshProcessingTool::InitializeProperties();		// allow base class to add shared properties
+}
+
+
+void UIGLGeodesicsTool::OnShutdown(EToolShutdownType ShutdownType)
+{
+	UMeshProcessingTool::OnShutdown(ShutdownType);
+	GeodesicsProperties->SaveProperties(this);
+}
+
+
+TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> UIGLGeodesicsTool::MakeMeshProcessingFunction()
+{
+	// Do *not* use & capture or reference this class directly in the lambda constructed below.
+	// Make copies of values. Otherwise compute thread may reference changing values.
+	TArray<int> SourceVertices = GeodesicsProperties->SourceVertices;
+	double TimeStepScale = FMath::Max(GeodesicsProperties->TimeStepScale, 0.001f);
+	double RippleWavelength = FMath::Max(GeodesicsProperties->RippleWavelength, 0.001f);
+	double RippleAmplitude = GeodesicsProperties->RippleAmplitude;
+
+	// the cache is shared with the lambda, it is only ever built from the (unchanging) input mesh
+	if (GeodesicsCache.IsValid() == false)
+	{
+		GeodesicsCache = MakeShared<FIGLGeodesicsCache, ESPMode::ThreadSafe>();
+	}
+	TSharedPtr<FIGLGeodesicsCache, ESPMode::ThreadSafe> Cache = GeodesicsCache;
+
+	// construct compute lambda
+	auto EditFunction = [SourceVertices, TimeStepScale, RippleWavelength, RippleAmplitude, Cache](FDynamicMesh3& ResultMesh, FProgressCancel* Progress, FMeshProcessingResultInfo& ResultInfo)
+	{
+		// convert FDynamicMesh3 to igl mesh representation, if not done yet
+		Cache->Build(ResultMesh);
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+
+		// factorize the heat and Poisson systems, if not done yet for this time step
+		TSharedPtr<FIGLHeatGeodesicsData, ESPMode::ThreadSafe> HeatData = Cache->GetHeatData(TimeStepScale);
+		if (HeatData.IsValid() == false || (Progress && Progress->Cancelled()))
+		{
+			return;
+		}
+
+		const iglext::FIGLMeshIndexMap& IndexMap = Cache->IndexMap;
+		TArray<int32> SourceRows;
+		for (int vid : SourceVertices)
+		{
+			if (ResultMesh.IsVertex(vid))
+			{
+				SourceRows.Add(IndexMap.GetVertexRow(vid));
+			}
+		}
+		if (SourceRows.Num() == 0)
+		{
+			SourceRows.Add(0);
+		}
+
+		// 1) heat flow from the sources, only a back-substitution with the precomputed factorization
+		Eigen::VectorXd Delta = Eigen::VectorXd::Zero(IndexMap.NumVertices);
+		for (int32 Row : SourceRows)
+		{
+			Delta(Row) = 1.0;
+		}
+		Eigen::VectorXd Heat = HeatData->HeatSolver.solve(Delta);
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+
+		// 2) normalized negative heat gradient in each face, which points away from the sources
+		Eigen::VectorXd Field = Cache->Grad * Heat;
+		int32 NumFaces = IndexMap.NumTriangles;
+		ParallelFor(NumFaces, [&](int32 Face)
+		{
+			double Length = FMathd::Sqrt(Field(Face) * Field(Face) + Field(NumFaces + Face) * Field(NumFaces + Face) + Field(2 * NumFaces + Face) * Field(2 * NumFaces + Face));
+			for (int32 d = 0; d < 3; ++d)
+			{
+				Field(d * NumFaces + Face) = (Length > 0) ? (-Field(d * NumFaces + Face) / Length) : 0.0;
+			}
+		});
+
+		// 3) distance is the function whose gradient best matches the field, ie the solution of the Poisson problem -L*D = Div*Field
+		Eigen::VectorXd D = HeatData->PoissonSolver.solve(Cache->Div * Field);
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+
+		// shift so the sources are at distance zero, and flip if the solution has the opposite sign
+		double SourceMean = 0;
+		for (int32 Row : SourceRows)
+		{
+			SourceMean += D(Row);
+		}
+		D.array() -= SourceMean / (double)SourceRows.Num();
+		if (D.mean() < 0)
+		{
+			D = -D;
+		}
+
+		// displace the vertices along their normals by a wave of the distance
+		double Wavelength = RippleWavelength * Cache->MeshSize;
+		double Amplitude = RippleAmplitude * Cache->MeshSize;
+		const Eigen::MatrixXd& V = Cache->V;
+		ParallelFor(IndexMap.NumVertices, [&](int32 Row)
+		{
+			int32 vid = IndexMap.GetVertexID(Row);
+			double Offset = Amplitude * FMathd::Sin(FMathd::TwoPi * D(Row) / Wavelength);
+			FVector3d Position(V(Row, 0), V(Row, 1), V(Row, 2));
+			ResultMesh.SetVertex(vid, Position + Offset * Cache->Normals[vid]);
+		});
+	};
+
+	return MoveTemp(EditFunction);  // return compute lambda
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -13,12 +13,16 @@
 #endif
 
 // set of libigl includes (you can add others here. If you uncomment the warning(pop) below, you may *need* to add them here)
+#include <igl/avg_edge_length.h>
 #include <igl/barycenter.h>
 #include <igl/cotmatrix.h>
 #include <igl/doublearea.h>
 #include <igl/grad.h>
 #include <igl/massmatrix.h>
+#include <igl/per_face_normals.h>
 #include <igl/per_vertex_normals.h>
+#include <igl/polar_svd3x3.h>
+#include <igl/triangle_triangle_adjacency.h>
 
 // un-disable the warnings
 // note: leaving them disabled is bad behavior but it means the igl headers can be included elsewhere w/o having to push/pop the warnings again
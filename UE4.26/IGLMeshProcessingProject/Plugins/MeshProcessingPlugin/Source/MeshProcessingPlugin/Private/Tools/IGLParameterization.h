@@ -0,0 +1,299 @@
+#pragma once
+#include "IGLIncludes.h"
+#include "Async/ParallelFor.h"
+#include <Eigen/SparseCholesky>
+
+//
+// Chart-based UV parameterization of libigl meshes. The mesh is split into charts, each chart is flattened with a
+// Least-Squares Conformal Map [Levy et al. 2002], and the charts are packed into the unit square. The per-chart systems
+// are independent and small, so they can be solved in parallel. igl::lscm is not used because igl::min_quad_with_fixed
+// needs the unsupported Eigen modules, so the free-vertex block of the same system is assembled and factorized here.
+//
+
+namespace iglext
+{
+	/**
+	 * Partition the faces of (V,F) into charts. Each chart is grown from a seed face across edges, as long as the face normals
+	 * stay within MaxNormalDeviationDeg of the average normal of the chart, which keeps the charts close to developable and disk-like.
+	 * @param TT face adjacency from igl::triangle_triangle_adjacency
+	 * @param FaceChartOut chart index of each face
+	 */
+	inline void ComputeNormalConeCharts(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F, const Eigen::MatrixXi& TT, double MaxNormalDeviationDeg,
+		TArray<TArray<int32>>& ChartsOut, TArray<int32>& FaceChartOut)
+	{
+		Eigen::MatrixXd N;
+		igl::per_face_normals(V, F, N);
+		Eigen::VectorXd DoubleAreas;
+		igl::doublearea(V, F, DoubleAreas);
+
+		double MinCos = FMathd::Cos(FMathd::Clamp(MaxNormalDeviationDeg, 1.0, 89.0) * FMathd::DegToRad);
+
+		int32 NumFaces = (int32)F.rows();
+		ChartsOut.Reset();
+		FaceChartOut.Init(-1, NumFaces);
+		TArray<int32> Queue;
+		for (int32 Seed = 0; Seed < NumFaces; ++Seed)
+		{
+			if (FaceChartOut[Seed] >= 0)
+			{
+				continue;
+			}
+
+			int32 ChartIndex = ChartsOut.Num();
+			TArray<int32>& Chart = ChartsOut.Emplace_GetRef();
+			Eigen::RowVector3d NormalSum = DoubleAreas[Seed] * N.row(Seed);
+			Eigen::RowVector3d ChartNormal = N.row(Seed);
+			FaceChartOut[Seed] = ChartIndex;
+			Chart.Add(Seed);
+
+			Queue.Reset();
+			Queue.Add(Seed);
+			for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+			{
+				for (int32 j = 0; j < 3; ++j)
+				{
+					int32 Nbr = TT(Queue[QueueIndex], j);
+					if (Nbr >= 0 && FaceChartOut[Nbr] < 0 && N.row(Nbr).dot(ChartNormal) >= MinCos)
+					{
+						FaceChartOut[Nbr] = ChartIndex;
+						Chart.Add(Nbr);
+						Queue.Add(Nbr);
+						NormalSum += DoubleAreas[Nbr] * N.row(Nbr);
+						double Length = NormalSum.norm();
+						if (Length > FMathd::ZeroTolerance)
+						{
+							ChartNormal = NormalSum / Length;
+						}
+					}
+				}
+			}
+		}
+	}
+
+
+	/**
+	 * Compute the Least-Squares Conformal Map of one chart from ComputeNormalConeCharts(). Two distant boundary vertices are pinned,
+	 * which fixes the similarity transform of the map, so the UVs have the same scale as V.
+	 * @param ChartVerticesOut rows of V of the chart vertices
+	 * @param UVOut UV of each vertex in ChartVerticesOut
+	 * @return false if the chart has no boundary or the system could not be factorized
+	 */
+	inline bool ComputeChartLSCM(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F, const Eigen::MatrixXi& TT, const TArray<int32>& FaceChart,
+		const TArray<int32>& ChartFaces, TArray<int32>& ChartVerticesOut, Eigen::MatrixXd& UVOut)
+	{
+		int32 ChartIndex = FaceChart[ChartFaces[0]];
+
+		// chart-local mesh
+		TMap<int32, int32> LocalIndex;
+		ChartVerticesOut.Reset();
+		Eigen::MatrixXi ChartF(ChartFaces.Num(), 3);
+		for (int32 k = 0; k < ChartFaces.Num(); ++k)
+		{
+			for (int32 j = 0; j < 3; ++j)
+			{
+				int32 Row = F(ChartFaces[k], j);
+				int32* Found = LocalIndex.Find(Row);
+				if (Found == nullptr)
+				{
+					Found = &LocalIndex.Add(Row, ChartVerticesOut.Num());
+					ChartVerticesOut.Add(Row);
+				}
+				ChartF(k, j) = *Found;
+			}
+		}
+		int32 NumVertices = ChartVerticesOut.Num();
+		Eigen::MatrixXd ChartV(NumVertices, 3);
+		for (int32 k = 0; k < NumVertices; ++k)
+		{
+			ChartV.row(k) = V.row(ChartVerticesOut[k]);
+		}
+
+		// LSCM energy with x = [u; v] is 1/2 x^T (diag(-L, -L) - A) x, the Dirichlet energy minus the signed UV area
+		Eigen::SparseMatrix<double> L;
+		igl::cotmatrix(ChartV, ChartF, L);
+		std::vector<Eigen::Triplet<double>> Entries;
+		Entries.reserve(2 * L.nonZeros() + 4 * ChartFaces.Num());
+		for (int32 Col = 0; Col < L.outerSize(); ++Col)
+		{
+			for (Eigen::SparseMatrix<double>::InnerIterator It(L, Col); It; ++It)
+			{
+				Entries.emplace_back((int32)It.row(), (int32)It.col(), -It.value());
+				Entries.emplace_back(NumVertices + (int32)It.row(), NumVertices + (int32)It.col(), -It.value());
+			}
+		}
+
+		// edge j of face f is (F(f,j), F(f,j+1)), it is on the chart boundary if there is no neighbour in the same chart
+		TArray<int32> BoundaryVertices;
+		for (int32 k = 0; k < ChartFaces.Num(); ++k)
+		{
+			for (int32 j = 0; j < 3; ++j)
+			{
+				int32 Nbr = TT(ChartFaces[k], j);
+				if (Nbr < 0 || FaceChart[Nbr] != ChartIndex)
+				{
+					int32 I = ChartF(k, j), J = ChartF(k, (j + 1) % 3);
+					BoundaryVertices.Add(I);
+					// signed area is 1/2 * sum over boundary edges of (u_i v_j - u_j v_i)
+					Entries.emplace_back(I, NumVertices + J, -0.5);
+					Entries.emplace_back(NumVertices + J, I, -0.5);
+					Entries.emplace_back(J, NumVertices + I, 0.5);
+					Entries.emplace_back(NumVertices + I, J, 0.5);
+				}
+			}
+		}
+		if (BoundaryVertices.Num() == 0)
+		{
+			return false;
+		}
+
+		// pin two distant boundary vertices
+		auto FindFarthestBoundaryVertex = [&](int32 FromVertex)
+		{
+			int32 Farthest = FromVertex;
+			double MaxDistSqr = -1;
+			for (int32 Vertex : BoundaryVertices)
+			{
+				double DistSqr = (ChartV.row(Vertex) - ChartV.row(FromVertex)).squaredNorm();
+				if (DistSqr > MaxDistSqr)
+				{
+					MaxDistSqr = DistSqr;
+					Farthest = Vertex;
+				}
+			}
+			return Farthest;
+		};
+		int32 Pin0 = FindFarthestBoundaryVertex(BoundaryVertices[0]);
+		int32 Pin1 = FindFarthestBoundaryVertex(Pin0);
+		double PinDistance = (ChartV.row(Pin0) - ChartV.row(Pin1)).norm();
+		if (Pin0 == Pin1 || PinDistance < FMathd::ZeroTolerance)
+		{
+			return false;
+		}
+
+		// reduce to the free unknowns
+		TArray<int32> FreeIndex;
+		FreeIndex.SetNumUninitialized(2 * NumVertices);
+		Eigen::VectorXd PinnedValues = Eigen::VectorXd::Zero(2 * NumVertices);
+		PinnedValues[Pin1] = PinDistance;
+		int32 NumFree = 0;
+		for (int32 k = 0; k < 2 * NumVertices; ++k)
+		{
+			int32 Vertex = k % NumVertices;
+			FreeIndex[k] = (Vertex == Pin0 || Vertex == Pin1) ? -1 : NumFree++;
+		}
+		std::vector<Eigen::Triplet<double>> FreeEntries;
+		FreeEntries.reserve(Entries.size());
+		Eigen::VectorXd RHS = Eigen::VectorXd::Zero(NumFree);
+		for (const Eigen::Triplet<double>& Entry : Entries)
+		{
+			int32 Row = FreeIndex[Entry.row()], Col = FreeIndex[Entry.col()];
+			if (Row >= 0 && Col >= 0)
+			{
+				FreeEntries.emplace_back(Row, Col, Entry.value());
+			}
+			else if (Row >= 0)
+			{
+				RHS[Row] -= Entry.value() * PinnedValues[Entry.col()];
+			}
+		}
+		Eigen::SparseMatrix<double> FreeMatrix(NumFree, NumFree);
+		FreeMatrix.setFromTriplets(FreeEntries.begin(), FreeEntries.end());
+
+		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> Solver(FreeMatrix);
+		if (Solver.info() != Eigen::Success)
+		{
+			return false;
+		}
+		Eigen::VectorXd FreeValues = Solver.solve(RHS);
+		if (Solver.info() != Eigen::Success || FreeValues.allFinite() == false)
+		{
+			return false;
+		}
+
+		UVOut.resize(NumVertices, 2);
+		for (int32 k = 0; k < 2 * NumVertices; ++k)
+		{
+			UVOut(k % NumVertices, k / NumVertices) = (FreeIndex[k] >= 0) ? FreeValues[FreeIndex[k]] : PinnedValues[k];
+		}
+		return true;
+	}
+
+
+	/**
+	 * Pack chart UVs into the unit square with shelf packing of the chart bounding boxes, tallest charts first.
+	 * Charts are rotated to be wider than tall, and all charts are scaled uniformly, so relative texel density is preserved.
+	 * @param Gutter space between charts, as a fraction of the UV square
+	 */
+	inline void PackCharts(TArray<Eigen::MatrixXd>& ChartUVs, double Gutter)
+	{
+		int32 NumCharts = ChartUVs.Num();
+		TArray<FVector2d> ChartSizes;
+		ChartSizes.SetNumUninitialized(NumCharts);
+		ParallelFor(NumCharts, [&](int32 ChartIndex)
+		{
+			Eigen::MatrixXd& UV = ChartUVs[ChartIndex];
+			if (UV.rows() == 0)
+			{
+				ChartSizes[ChartIndex] = FVector2d::Zero();
+				return;
+			}
+			UV.rowwise() -= UV.colwise().minCoeff();
+			Eigen::RowVector2d Size = UV.colwise().maxCoeff();
+			if (Size[1] > Size[0])
+			{
+				// rotate by 90 degrees
+				Eigen::VectorXd U = UV.col(0);
+				UV.col(0) = UV.col(1);
+				UV.col(1) = Size[0] - U.array();
+				Size = Eigen::RowVector2d(Size[1], Size[0]);
+			}
+			ChartSizes[ChartIndex] = FVector2d(Size[0], Size[1]);
+		});
+
+		double TotalArea = 0, MaxWidth = 0;
+		for (const FVector2d& Size : ChartSizes)
+		{
+			TotalArea += Size.X * Size.Y;
+			MaxWidth = FMathd::Max(MaxWidth, Size.X);
+		}
+		// the packed size is estimated from the total chart area, to convert the gutter to chart units
+		double ChartGutter = Gutter * FMathd::Sqrt(TotalArea);
+
+		TArray<int32> Order;
+		Order.SetNumUninitialized(NumCharts);
+		for (int32 k = 0; k < NumCharts; ++k)
+		{
+			Order[k] = k;
+		}
+		Order.Sort([&](int32 A, int32 B) { return ChartSizes[A].Y > ChartSizes[B].Y; });
+
+		double ShelfWidth = FMathd::Max(FMathd::Sqrt(TotalArea) * 1.1, MaxWidth) + ChartGutter;
+		TArray<FVector2d> ChartOffsets;
+		ChartOffsets.SetNumUninitialized(NumCharts);
+		double ShelfX = ChartGutter, ShelfY = ChartGutter, ShelfHeight = 0, PackedWidth = 0;
+		for (int32 ChartIndex : Order)
+		{
+			const FVector2d& Size = ChartSizes[ChartIndex];
+			if (ShelfX + Size.X + ChartGutter > ShelfWidth && ShelfX > ChartGutter)
+			{
+				ShelfY += ShelfHeight + ChartGutter;
+				ShelfX = ChartGutter;
+				ShelfHeight = 0;
+			}
+			ChartOffsets[ChartIndex] = FVector2d(ShelfX, ShelfY);
+			ShelfX += Size.X + ChartGutter;
+			ShelfHeight = FMathd::Max(ShelfHeight, Size.Y);
+			PackedWidth = FMathd::Max(PackedWidth, ShelfX);
+		}
+		double PackedSize = FMathd::Max(PackedWidth, ShelfY + ShelfHeight + ChartGutter);
+		double Scale = (PackedSize > FMathd::ZeroTolerance) ? (1.0 / PackedSize) : 1.0;
+
+		ParallelFor(NumCharts, [&](int32 ChartIndex)
+		{
+			Eigen::MatrixXd& UV = ChartUVs[ChartIndex];
+			UV.col(0).array() = (UV.col(0).array() + ChartOffsets[ChartIndex].X) * Scale;
+			UV.col(1).array() = (UV.col(1).array() + ChartOffsets[ChartIndex].Y) * Scale;
+		});
+	}
+
+}
@@ -1,11 +1,70 @@
 #include "Tools/IGLSmoothingTool.h"
 #include "Tools/IGLIncludes.h"		// include this before your igl includes (or add them to the list there)
 #include "Tools/IGLUtil.h"
+#include "Tools/IGLSolverUtil.h"
+#include "Misc/ScopeLock.h"
 
 
 #define LOCTEXT_NAMESPACE "UIGLSmoothingTool"
 
 
+typedef Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> FIGLSmoothingSolver;
+
+/**
+ * Data for UIGLSmoothingTool that only depends on the input mesh. It is built by the first background computation
+ * and then reused by all following ones, so changing the tool settings does not recompute it.
+ */
+struct FIGLSmoothingCache
+{
+	FCriticalSection BuildLock;
+	bool bBuilt = false;
+
+	// input mesh in libigl representation, IndexMap maps it to the (possibly non-compact) input mesh
+	iglext::FIGLMeshIndexMap IndexMap;
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi F;
+	// cotangent Laplacian of the input mesh
+	Eigen::SparseMatrix<double> L;
+
+	// Direct solver with the symbolic analysis of (M - delta*L) computed on first use. The mass matrix M is diagonal, so the sparsity
+	// pattern is the pattern of L and does not change with delta or the vertex positions, only the numeric factorization does.
+	// It can only be used by one computation at a time, SolverLock must be held while using it.
+	FCriticalSection SolverLock;
+	bool bSolverAnalyzed = false;
+	FIGLSmoothingSolver Solver;
+
+	// multigrid hierarchy for the pattern of L, built on first use
+	FCriticalSection HierarchyLock;
+	TUniquePtr<iglext::FAggregationHierarchy> MultigridHierarchy;
+
+	void Build(const FDynamicMesh3& Mesh)
+	{
+		FScopeLock Lock(&BuildLock);
+		if (bBuilt)
+		{
+			return;
+		}
+
+		IndexMap.Build(Mesh);
+		iglext::DynamicMeshToIGLMesh(Mesh, IndexMap, V, F);
+		igl::cotmatrix(V, F, L);
+
+		bBuilt = true;
+	}
+
+	const iglext::FAggregationHierarchy& GetMultigridHierarchy()
+	{
+		FScopeLock Lock(&HierarchyLock);
+		if (MultigridHierarchy.IsValid() == false)
+		{
+			MultigridHierarchy = MakeUnique<iglext::FAggregationHierarchy>();
+			MultigridHierarchy->Build(iglext::FRowMajorSparseMatrix(L));
+		}
+		return *MultigridHierarchy;
+	}
+};
+
+
 
 void UIGLSmoothingTool::InitializeProperties()
 {
@@ -14,6 +73,8 @@ void UIGLSmoothingTool::InitializeProperties()
 	SmoothProperties->RestoreProperties(this);
 	SmoothProperties->WatchProperty(SmoothProperties->Smoothness, [&](float) { InvalidateResult(); });
 	SmoothProperties->WatchProperty(SmoothProperties->Iterations, [&](int) { InvalidateResult(); });
+	SmoothProperties->WatchProperty(SmoothProperties->Solver, [&](EIGLSmoothingSolverType) { InvalidateResult(); });
+	SmoothProperties->WatchProperty(SmoothProperties->SolverTolerance, [&](float) { InvalidateResult(); });
 
 	UMeshProcessingTool::InitializeProperties();		// allow base class to add shared properties
 }
@@ -26,45 +87,128 @@ void UIGLSmoothingTool::OnShutdown(EToolShutdownType ShutdownType)
 }
 
 
-TUniqueFunction<void(FDynamicMesh3&)> UIGLSmoothingTool::MakeMeshProcessingFunction()
+TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> UIGLSmoothingTool::MakeMeshProcessingFunction()
 {
 	// Do *not* use & capture or reference this class directly in the lambda constructed below.
 	// Make copies of values. Otherwise compute thread may reference changing values.
 	int SolveIterations = SmoothProperties->Iterations;
 	float Smoothness = SmoothProperties->Smoothness / 10000.0;
+	EIGLSmoothingSolverType SolverType = SmoothProperties->Solver;
+	double SolverTolerance = FMath::Max(SmoothProperties->SolverTolerance, 1e-12f);
+
+	// the cache is shared with the lambda, it is only ever built from the (unchanging) input mesh
+	if (SmoothingCache.IsValid() == false)
+	{
+		SmoothingCache = MakeShared<FIGLSmoothingCache, ESPMode::ThreadSafe>();
+	}
+	TSharedPtr<FIGLSmoothingCache, ESPMode::ThreadSafe> Cache = SmoothingCache;
 
 	// construct compute lambda
-	auto EditFunction = [Smoothness, SolveIterations](FDynamicMesh3& ResultMesh)
+	auto EditFunction = [Smoothness, SolveIterations, SolverType, SolverTolerance, Cache](FDynamicMesh3& ResultMesh, FProgressCancel* Progress, FMeshProcessingResultInfo& ResultInfo)
 	{
 		// this code is based on libigl tutorial 205_Laplacian
 		// https://github.com/libigl/libigl/blob/master/tutorial/205_Laplacian/main.cpp
 
-		// convert FDynamicMesh3 to igl mesh representation
-		Eigen::MatrixXd V;
-		Eigen::MatrixXi F;
-		iglext::DynamicMeshToIGLMesh(ResultMesh, V, F);
-
-		// Compute Laplace-Beltrami operator L (#V by #V matrix)
-		Eigen::SparseMatrix<double> L;
-		igl::cotmatrix(V, F, L);
+		// convert FDynamicMesh3 to igl mesh representation and compute Laplace-Beltrami operator L (#V by #V matrix), if not done yet
+		Cache->Build(ResultMesh);
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+		const Eigen::MatrixXi& F = Cache->F;
+		const Eigen::SparseMatrix<double>& L = Cache->L;
 
 		// smoothed positions will be computed in U
-		Eigen::MatrixXd U = V;
+		Eigen::MatrixXd U = Cache->V;
 
-		for (int k = 0; k < SolveIterations; ++k)
+		if (SolverType == EIGLSmoothingSolverType::Direct)
 		{
-			// Recompute mass matrix on each step
-			Eigen::SparseMatrix<double> M;
-			igl::massmatrix(U, F, igl::MASSMATRIX_TYPE_BARYCENTRIC, M);
-
-			// Solve (M-delta*L) U = M*U
-			const auto& S = (M - Smoothness * L);
-			Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> solver(S);
-			assert(solver.info() == Eigen::Success);
-			U = solver.solve(M * U).eval();
+			// Use the cached solver unless another computation is still using it (eg a computation for previous settings
+			// that has not finished yet), in that case do the symbolic analysis on a local solver.
+			bool bUseCachedSolver = Cache->SolverLock.TryLock();
+			TUniquePtr<FIGLSmoothingSolver> LocalSolver;
+			if (!bUseCachedSolver)
+			{
+				LocalSolver = MakeUnique<FIGLSmoothingSolver>();
+			}
+			FIGLSmoothingSolver& Solver = (bUseCachedSolver) ? Cache->Solver : *LocalSolver;
+			bool bAnalyzed = (bUseCachedSolver && Cache->bSolverAnalyzed);
+
+			for (int k = 0; k < SolveIterations; ++k)
+			{
+				if (Progress && Progress->Cancelled())
+				{
+					break;
+				}
+
+				// Recompute mass matrix on each step
+				Eigen::SparseMatrix<double> M;
+				igl::massmatrix(U, F, igl::MASSMATRIX_TYPE_BARYCENTRIC, M);
+
+				// Solve (M-delta*L) U = M*U. Only the numeric factorization is recomputed, the symbolic analysis is reused.
+				Eigen::SparseMatrix<double> S = (M - Smoothness * L);
+				if (!bAnalyzed)
+				{
+					Solver.analyzePattern(S);
+					bAnalyzed = true;
+				}
+				Solver.factorize(S);
+				if (Solver.info() != Eigen::Success)
+				{
+					break;
+				}
+				U = Solver.solve(M * U).eval();
+			}
+
+			if (bUseCachedSolver)
+			{
+				Cache->bSolverAnalyzed = bAnalyzed;
+				Cache->SolverLock.Unlock();
+			}
 		}
-		
-		iglext::SetVertexPositions(ResultMesh, U);   // copy updated positions back to FDynamicMesh3
+		else
+		{
+			const int32 MaxSolverIterations = 1000;
+			for (int k = 0; k < SolveIterations; ++k)
+			{
+				if (Progress && Progress->Cancelled())
+				{
+					break;
+				}
+
+				Eigen::SparseMatrix<double> M;
+				igl::massmatrix(U, F, igl::MASSMATRIX_TYPE_BARYCENTRIC, M);
+
+				// Solve (M-delta*L) U = M*U, starting from the current U
+				iglext::FRowMajorSparseMatrix S = (M - Smoothness * L);
+				Eigen::MatrixXd B = M * U;
+				if (SolverType == EIGLSmoothingSolverType::Multigrid)
+				{
+					iglext::FMultigridPreconditioner Preconditioner;
+					if (Preconditioner.Setup(S, Cache->GetMultigridHierarchy()) == false)
+					{
+						break;
+					}
+					iglext::ParallelPCG(S, B, U, Preconditioner, SolverTolerance, MaxSolverIterations, Progress);
+				}
+				else
+				{
+					iglext::FJacobiPreconditioner Preconditioner;
+					Preconditioner.Setup(S);
+					iglext::ParallelPCG(S, B, U, Preconditioner, SolverTolerance, MaxSolverIterations, Progress);
+				}
+			}
+		}
+
+		if (Progress && Progress->Cancelled())
+		{
+			return;		// result will be discarded
+		}
+
+		iglext::SetVertexPositions(ResultMesh, Cache->IndexMap, U, &ResultInfo.ModifiedVertices);   // copy updated positions back to FDynamicMesh3
+
+		// only the normals around the vertices that moved have to be recomputed
+		ResultInfo.bOnlyModifiedListedVertices = true;
 	};
 
 	return MoveTemp(EditFunction);  // return compute lambda
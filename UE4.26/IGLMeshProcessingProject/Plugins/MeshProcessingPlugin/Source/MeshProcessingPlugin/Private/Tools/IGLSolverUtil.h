@@ -0,0 +1,317 @@
+#pragma once
+#include "IGLIncludes.h"
+#include "Async/ParallelFor.h"
+#include "Util/ProgressCancel.h"
+
+//
+// Iterative solvers for sparse symmetric positive definite systems A X = B with multiple right-hand sides (eg one per coordinate axis).
+// Unlike the Eigen iterative solvers (which need OpenMP to use multiple threads), the sparse matrix products are multithreaded with ParallelFor,
+// and memory use only grows with the number of nonzeros of A, as there is no factorization fill-in.
+//
+
+namespace iglext
+{
+	typedef Eigen::SparseMatrix<double, Eigen::RowMajor> FRowMajorSparseMatrix;
+
+
+	// Call RowFunc(Row) for each Row in [0, NumRows), in parallel over blocks of rows
+	template<typename RowFuncType>
+	void ParallelForRows(int32 NumRows, RowFuncType RowFunc)
+	{
+		const int32 BlockSize = 1024;
+		int32 NumBlocks = (NumRows + BlockSize - 1) / BlockSize;
+		ParallelFor(NumBlocks, [&](int32 BlockIndex)
+		{
+			int32 EndRow = FMath::Min(NumRows, (BlockIndex + 1) * BlockSize);
+			for (int32 Row = BlockIndex * BlockSize; Row < EndRow; ++Row)
+			{
+				RowFunc(Row);
+			}
+		});
+	}
+
+
+	// Compute Y = A*X in parallel over the rows of A
+	inline void ParallelMultiply(const FRowMajorSparseMatrix& A, const Eigen::MatrixXd& X, Eigen::MatrixXd& Y)
+	{
+		Y.resize(A.rows(), X.cols());
+		const int32 NumCols = (int32)X.cols();
+		ParallelForRows((int32)A.rows(), [&](int32 Row)
+		{
+			for (int32 Col = 0; Col < NumCols; ++Col)
+			{
+				double Sum = 0;
+				for (FRowMajorSparseMatrix::InnerIterator It(A, Row); It; ++It)
+				{
+					Sum += It.value() * X(It.col(), Col);
+				}
+				Y(Row, Col) = Sum;
+			}
+		});
+	}
+
+
+	// Inverse of the diagonal of A, zero where the diagonal is zero
+	inline void ComputeInverseDiagonal(const FRowMajorSparseMatrix& A, Eigen::VectorXd& InvDiagonalOut)
+	{
+		InvDiagonalOut = A.diagonal();
+		for (int32 k = 0; k < InvDiagonalOut.size(); ++k)
+		{
+			InvDiagonalOut(k) = (InvDiagonalOut(k) != 0) ? (1.0 / InvDiagonalOut(k)) : 0.0;
+		}
+	}
+
+
+	// Jacobi (diagonal) preconditioner
+	class FJacobiPreconditioner
+	{
+	public:
+		Eigen::VectorXd InvDiagonal;
+
+		bool Setup(const FRowMajorSparseMatrix& A)
+		{
+			ComputeInverseDiagonal(A, InvDiagonal);
+			return true;
+		}
+
+		// Z = inverse(diagonal(A)) * R
+		void Apply(const Eigen::MatrixXd& R, Eigen::MatrixXd& Z) const
+		{
+			Z = InvDiagonal.asDiagonal() * R;
+		}
+	};
+
+
+	// Hierarchy of coarsened versions of the graph of a sparse matrix, for FMultigridPreconditioner. Rows are merged with their
+	// neighbours into aggregates, so for a mesh Laplacian each level is a vertex clustering of the previous level's mesh.
+	// The hierarchy only depends on the sparsity pattern, so it can be shared by matrices with the same pattern but different values.
+	class FAggregationHierarchy
+	{
+	public:
+		// Prolongations[k] maps level k+1 to level k (level 0 is the input matrix). Each row has a single 1 in the column of its aggregate.
+		TArray<FRowMajorSparseMatrix> Prolongations;
+
+		void Build(const FRowMajorSparseMatrix& A, int32 CoarsestSize = 1000, int32 MaxLevels = 20)
+		{
+			Prolongations.Reset();
+			FRowMajorSparseMatrix LevelMatrix = A;
+			while (LevelMatrix.rows() > CoarsestSize && Prolongations.Num() < MaxLevels)
+			{
+				FRowMajorSparseMatrix P;
+				int32 NumAggregates = ComputeAggregates(LevelMatrix, P);
+				if (NumAggregates > (3 * LevelMatrix.rows()) / 4)
+				{
+					break;		// graph is not coarsening anymore
+				}
+				FRowMajorSparseMatrix CoarseMatrix = P.transpose() * LevelMatrix * P;
+				Prolongations.Add(MoveTemp(P));
+				LevelMatrix = MoveTemp(CoarseMatrix);
+			}
+		}
+
+		int32 NumLevels() const { return Prolongations.Num() + 1; }
+
+	protected:
+		static int32 ComputeAggregates(const FRowMajorSparseMatrix& A, FRowMajorSparseMatrix& ProlongationOut)
+		{
+			int32 N = (int32)A.rows();
+			TArray<int32> Aggregate;
+			Aggregate.Init(-1, N);
+			int32 NumAggregates = 0;
+
+			// rows whose neighbours are all unassigned start a new aggregate with their neighbours
+			for (int32 Row = 0; Row < N; ++Row)
+			{
+				bool bAllFree = true;
+				for (FRowMajorSparseMatrix::InnerIterator It(A, Row); It && bAllFree; ++It)
+				{
+					bAllFree = (Aggregate[(int32)It.col()] < 0);
+				}
+				if (bAllFree)
+				{
+					for (FRowMajorSparseMatrix::InnerIterator It(A, Row); It; ++It)
+					{
+						Aggregate[(int32)It.col()] = NumAggregates;
+					}
+					Aggregate[Row] = NumAggregates;
+					NumAggregates++;
+				}
+			}
+
+			// remaining rows join a neighbouring aggregate
+			for (int32 Row = 0; Row < N; ++Row)
+			{
+				for (FRowMajorSparseMatrix::InnerIterator It(A, Row); It && Aggregate[Row] < 0; ++It)
+				{
+					Aggregate[Row] = Aggregate[(int32)It.col()];
+				}
+			}
+
+			// isolated rows become their own aggregate
+			for (int32 Row = 0; Row < N; ++Row)
+			{
+				if (Aggregate[Row] < 0)
+				{
+					Aggregate[Row] = NumAggregates++;
+				}
+			}
+
+			TArray<Eigen::Triplet<double>> Triplets;
+			Triplets.Reserve(N);
+			for (int32 Row = 0; Row < N; ++Row)
+			{
+				Triplets.Add(Eigen::Triplet<double>(Row, Aggregate[Row], 1.0));
+			}
+			ProlongationOut.resize(N, NumAggregates);
+			ProlongationOut.setFromTriplets(Triplets.GetData(), Triplets.GetData() + Triplets.Num());
+			return NumAggregates;
+		}
+	};
+
+
+	// Preconditioner that applies one multigrid V-cycle, with weighted Jacobi smoothing on each level of an FAggregationHierarchy
+	// and a direct solve on the coarsest level. Pre- and post-smoothing are symmetric, so it can be used with conjugate gradients.
+	class FMultigridPreconditioner
+	{
+	public:
+		int32 NumSmoothingSteps = 2;
+		double JacobiWeight = 2.0 / 3.0;
+
+		// Compute the coarse-level operators for the values of A, which must have the sparsity pattern the Hierarchy was built from.
+		// A and Hierarchy must exist as long as this preconditioner is used.
+		bool Setup(const FRowMajorSparseMatrix& A, const FAggregationHierarchy& HierarchyIn)
+		{
+			Hierarchy = &HierarchyIn;
+			FineOperator = &A;
+			int32 NumLevels = Hierarchy->NumLevels();
+
+			CoarseOperators.SetNum(NumLevels - 1);
+			for (int32 Level = 0; Level < NumLevels - 1; ++Level)
+			{
+				const FRowMajorSparseMatrix& P = Hierarchy->Prolongations[Level];
+				CoarseOperators[Level] = P.transpose() * GetOperator(Level) * P;
+			}
+
+			InvDiagonals.SetNum(NumLevels);
+			for (int32 Level = 0; Level < NumLevels; ++Level)
+			{
+				ComputeInverseDiagonal(GetOperator(Level), InvDiagonals[Level]);
+			}
+
+			CoarsestSolver.compute(Eigen::SparseMatrix<double>(GetOperator(NumLevels - 1)));
+			return (CoarsestSolver.info() == Eigen::Success);
+		}
+
+		void Apply(const Eigen::MatrixXd& R, Eigen::MatrixXd& Z) const
+		{
+			VCycle(0, R, Z);
+		}
+
+	protected:
+		const FAggregationHierarchy* Hierarchy = nullptr;
+		const FRowMajorSparseMatrix* FineOperator = nullptr;
+		TArray<FRowMajorSparseMatrix> CoarseOperators;
+		TArray<Eigen::VectorXd> InvDiagonals;
+		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> CoarsestSolver;
+
+		const FRowMajorSparseMatrix& GetOperator(int32 Level) const
+		{
+			return (Level == 0) ? *FineOperator : CoarseOperators[Level - 1];
+		}
+
+		void VCycle(int32 Level, const Eigen::MatrixXd& R, Eigen::MatrixXd& Z) const
+		{
+			if (Level == Hierarchy->NumLevels() - 1)
+			{
+				Z = CoarsestSolver.solve(R);
+				return;
+			}
+
+			const FRowMajorSparseMatrix& A = GetOperator(Level);
+			const Eigen::VectorXd& InvDiagonal = InvDiagonals[Level];
+			const FRowMajorSparseMatrix& P = Hierarchy->Prolongations[Level];
+			Eigen::MatrixXd AZ;
+
+			// pre-smoothing, starting from Z = 0
+			Z = JacobiWeight * (InvDiagonal.asDiagonal() * R);
+			for (int32 Step = 1; Step < NumSmoothingSteps; ++Step)
+			{
+				ParallelMultiply(A, Z, AZ);
+				Z += JacobiWeight * (InvDiagonal.asDiagonal() * (R - AZ));
+			}
+
+			// coarse-level correction
+			ParallelMultiply(A, Z, AZ);
+			Eigen::MatrixXd CoarseR = P.transpose() * (R - AZ);
+			Eigen::MatrixXd CoarseZ;
+			VCycle(Level + 1, CoarseR, CoarseZ);
+			Z += P * CoarseZ;
+
+			// post-smoothing
+			for (int32 Step = 0; Step < NumSmoothingSteps; ++Step)
+			{
+				ParallelMultiply(A, Z, AZ);
+				Z += JacobiWeight * (InvDiagonal.asDiagonal() * (R - AZ));
+			}
+		}
+	};
+
+
+	/**
+	 * Solve A X = B with preconditioned conjugate gradients. All columns of B are solved at the same time, so each sparse matrix product is shared.
+	 * @param X initial guess, replaced with the solution
+	 * @param Tolerance iterations stop when the residual norm of every column is below Tolerance times the norm of that column of B
+	 * @param Progress optional, checked every iteration, the solve stops if it is cancelled
+	 * @return number of iterations, or -1 if the solver did not converge in MaxIterations or was cancelled
+	 */
+	template<typename PreconditionerType>
+	int32 ParallelPCG(const FRowMajorSparseMatrix& A, const Eigen::MatrixXd& B, Eigen::MatrixXd& X,
+		const PreconditionerType& Preconditioner, double Tolerance, int32 MaxIterations, FProgressCancel* Progress = nullptr)
+	{
+		const int32 NumCols = (int32)B.cols();
+
+		Eigen::RowVectorXd ThresholdSqr = B.colwise().squaredNorm() * (Tolerance * Tolerance);
+
+		Eigen::MatrixXd R, Z, P, AP;
+		ParallelMultiply(A, X, AP);
+		R = B - AP;
+		Preconditioner.Apply(R, Z);
+		P = Z;
+		Eigen::RowVectorXd RZ = R.cwiseProduct(Z).colwise().sum();
+
+		for (int32 Iteration = 0; Iteration < MaxIterations; ++Iteration)
+		{
+			if (Progress && Progress->Cancelled())
+			{
+				return -1;
+			}
+
+			Eigen::RowVectorXd ResidualSqr = R.colwise().squaredNorm();
+			if ((ResidualSqr.array() <= ThresholdSqr.array()).all())
+			{
+				return Iteration;
+			}
+
+			ParallelMultiply(A, P, AP);
+			Eigen::RowVectorXd PAP = P.cwiseProduct(AP).colwise().sum();
+			for (int32 Col = 0; Col < NumCols; ++Col)
+			{
+				double Alpha = (PAP(Col) > 0) ? (RZ(Col) / PAP(Col)) : 0.0;
+				X.col(Col) += Alpha * P.col(Col);
+				R.col(Col) -= Alpha * AP.col(Col);
+			}
+
+			Preconditioner.Apply(R, Z);
+			Eigen::RowVectorXd NewRZ = R.cwiseProduct(Z).colwise().sum();
+			for (int32 Col = 0; Col < NumCols; ++Col)
+			{
+				double Beta = (RZ(Col) != 0) ? (NewRZ(Col) / RZ(Col)) : 0.0;
+				P.col(Col) = Z.col(Col) + Beta * P.col(Col);
+			}
+			RZ = NewRZ;
+		}
+
+		return -1;
+	}
+
+}
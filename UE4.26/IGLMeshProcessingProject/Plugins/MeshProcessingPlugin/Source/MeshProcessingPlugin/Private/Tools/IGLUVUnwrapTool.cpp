@@ -0,0 +1,182 @@
+#include "Tools/IGLUVUnwrapTool.h"
+#include "Tools/IGLIncludes.h"		// include this before your igl includes (or add them to the list there)
+#include "Tools/IGLUtil.h"
+#include "Tools/IGLParameterization.h"
+#include "DynamicMeshAttributeSet.h"
+#include "FrameTypes.h"
+#include "Misc/ScopeLock.h"
+
+
+#define LOCTEXT_NAMESPACE "UIGLUVUnwrapTool"
+
+
+/**
+ * Data for UIGLUVUnwrapTool that only depends on the input mesh. It is built by the first background computation
+ * and then reused by all following ones.
+ */
+struct FIGLUVUnwrapCache
+{
+	FCriticalSection BuildLock;
+	bool bBuilt = false;
+
+	// input mesh in libigl representation, IndexMap maps it to the (possibly non-compact) input mesh
+	iglext::FIGLMeshIndexMap IndexMap;
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi F;
+	// face adjacency, from igl::triangle_triangle_adjacency
+	Eigen::MatrixXi TT;
+
+	void Build(const FDynamicMesh3& Mesh)
+	{
+		FScopeLock Lock(&BuildLock);
+		if (bBuilt)
+		{
+			return;
+		}
+
+		IndexMap.Build(Mesh);
+		iglext::DynamicMeshToIGLMesh(Mesh, IndexMap, V, F);
+		igl::triangle_triangle_adjacency(F, TT);
+
+		bBuilt = true;
+	}
+};
+
+
+
+void UIGLUVUnwrapTool::InitializeProperties()
+{
+	UVUnwrapProperties = NewObject<UIGLUVUnwrapToolProperties>(this);
+	AddToolPropertySource(UVUnwrapProperties);
+	UVUnwrapProperties->RestoreProperties(this);
+	UVUnwrapProperties->WatchProperty(UVUnwrapProperties->MaxChartNormalAngle, [&](float) { InvalidateResult(); });
+	UVUnwrapProperties->WatchProperty(UVUnwrapProperties->Gutter, [&](float) { InvalidateResult(); });
+
+	UMeshProcessingTool::InitializeProperties();		// allow base class to add shared properties
+}
+
+
+void UIGLUVUnwrapTool::OnShutdown(EToolShutdownType ShutdownType)
+{
+	UMeshProcessingTool::OnShutdown(ShutdownType);
+	UVUnwrapProperties->SaveProperties(this);
+}
+
+
+TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> UIGLUVUnwrapTool::MakeMeshProcessingFunction()
+{
+	// Do *not* use & capture or reference this class directly in the lambda constructed below.
+	// Make copies of values. Otherwise compute thread may reference changing values.
+	double MaxChartNormalAngle = UVUnwrapProperties->MaxChartNormalAngle;
+	double Gutter = FMath::Max(UVUnwrapProperties->Gutter, 0.0f);
+
+	// the cache is shared with the lambda, it is only ever built from the (unchanging) input mesh
+	if (UVUnwrapCache.IsValid() == false)
+	{
+		UVUnwrapCache = MakeShared<FIGLUVUnwrapCache, ESPMode::ThreadSafe>();
+	}
+	TSharedPtr<FIGLUVUnwrapCache, ESPMode::ThreadSafe> Cache = UVUnwrapCache;
+
+	// construct compute lambda
+	auto EditFunction = [MaxChartNormalAngle, Gutter, Cache](FDynamicMesh3& ResultMesh, FProgressCancel* Progress, FMeshProcessingResultInfo& ResultInfo)
+	{
+		// convert FDynamicMesh3 to igl mesh representation, if not done yet
+		Cache->Build(ResultMesh);
+		const Eigen::MatrixXd& V = Cache->V;
+		const Eigen::MatrixXi& F = Cache->F;
+		const iglext::FIGLMeshIndexMap& IndexMap = Cache->IndexMap;
+
+		TArray<TArray<int32>> Charts;
+		TArray<int32> FaceChart;
+		iglext::ComputeNormalConeCharts(V, F, Cache->TT, MaxChartNormalAngle, Charts, FaceChart);
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+
+		// flatten the charts in parallel
+		int32 NumCharts = Charts.Num();
+		TArray<TArray<int32>> ChartVertices;
+		TArray<Eigen::MatrixXd> ChartUVs;
+		ChartVertices.SetNum(NumCharts);
+		ChartUVs.SetNum(NumCharts);
+		ParallelFor(NumCharts, [&](int32 ChartIndex)
+		{
+			if (Progress && Progress->Cancelled())
+			{
+				return;
+			}
+			const TArray<int32>& Chart = Charts[ChartIndex];
+			if (iglext::ComputeChartLSCM(V, F, Cache->TT, FaceChart, Chart, ChartVertices[ChartIndex], ChartUVs[ChartIndex]))
+			{
+				return;
+			}
+
+			// fall back to projection onto the plane of the first chart face
+			TArray<int32>& Vertices = ChartVertices[ChartIndex];
+			Vertices.Reset();
+			TSet<int32> VertexSet;
+			for (int32 Face : Chart)
+			{
+				for (int32 j = 0; j < 3; ++j)
+				{
+					bool bAlreadyInSet = false;
+					VertexSet.Add(F(Face, j), &bAlreadyInSet);
+					if (bAlreadyInSet == false)
+					{
+						Vertices.Add(F(Face, j));
+					}
+				}
+			}
+			FVector3d A(V(F(Chart[0], 0), 0), V(F(Chart[0], 0), 1), V(F(Chart[0], 0), 2));
+			FVector3d B(V(F(Chart[0], 1), 0), V(F(Chart[0], 1), 1), V(F(Chart[0], 1), 2));
+			FVector3d C(V(F(Chart[0], 2), 0), V(F(Chart[0], 2), 1), V(F(Chart[0], 2), 2));
+			FFrame3d ProjectionFrame(A, (B - A).Cross(C - A).Normalized());
+			Eigen::MatrixXd& UV = ChartUVs[ChartIndex];
+			UV.resize(Vertices.Num(), 2);
+			for (int32 k = 0; k < Vertices.Num(); ++k)
+			{
+				FVector2d ProjectedUV = ProjectionFrame.ToPlaneUV(FVector3d(V(Vertices[k], 0), V(Vertices[k], 1), V(Vertices[k], 2)), 2);
+				UV(k, 0) = ProjectedUV.X;
+				UV(k, 1) = ProjectedUV.Y;
+			}
+		});
+		if (Progress && Progress->Cancelled())
+		{
+			return;
+		}
+
+		iglext::PackCharts(ChartUVs, Gutter);
+
+		// copy the UVs to the primary UV layer, with one element per chart vertex so the chart borders become seams
+		if (ResultMesh.HasAttributes() == false)
+		{
+			ResultMesh.EnableAttributes();
+		}
+		FDynamicMeshUVOverlay* UVOverlay = ResultMesh.Attributes()->PrimaryUV();
+		UVOverlay->ClearElements();
+		TArray<int32> RowElements;
+		RowElements.Init(FDynamicMesh3::InvalidID, IndexMap.NumVertices);
+		for (int32 ChartIndex = 0; ChartIndex < NumCharts; ++ChartIndex)
+		{
+			const TArray<int32>& Vertices = ChartVertices[ChartIndex];
+			const Eigen::MatrixXd& UV = ChartUVs[ChartIndex];
+			for (int32 k = 0; k < Vertices.Num(); ++k)
+			{
+				RowElements[Vertices[k]] = UVOverlay->AppendElement(FVector2f((float)UV(k, 0), (float)UV(k, 1)));
+			}
+			for (int32 Face : Charts[ChartIndex])
+			{
+				UVOverlay->SetTriangle(IndexMap.GetTriangleID(Face), FIndex3i(RowElements[F(Face, 0)], RowElements[F(Face, 1)], RowElements[F(Face, 2)]));
+			}
+		}
+
+		// vertex positions are unchanged, so the normals do not have to be recomputed
+		ResultInfo.bOnlyModifiedListedVertices = true;
+	};
+
+	return MoveTemp(EditFunction);  // return compute lambda
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -1,6 +1,7 @@
 #pragma once
 #include "IGLIncludes.h"
 #include "DynamicMesh3.h"
+#include "Async/ParallelFor.h"
 
 //
 // Utility functions for converting between UE and libigl data structures
@@ -9,45 +10,130 @@
 namespace iglext
 {
 
-	// Convert a UE FDynamicMesh3 to libigl-style indexed triangle mesh
-	// V is Nx3 matrix of vertex positions
-	// F is Nx3 matrix of triangle indices
-	void DynamicMeshToIGLMesh(const FDynamicMesh3& Mesh, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
+	// Mapping between the vertex/triangle IDs of a FDynamicMesh3 and the rows of the libigl V/F matrices.
+	// If the mesh is not compact (ie has unused IDs), the rows are the used IDs in increasing order.
+	// The map stays valid for copies of the mesh, and for modifications that do not add or remove vertices or triangles,
+	// so it can be computed once and reused for repeated conversions.
+	struct FIGLMeshIndexMap
 	{
-		check(Mesh.IsCompactV());
+		// true if the mesh is compact, in which case the arrays below are empty and rows are equal to IDs
+		bool bIdentity = true;
+		// row -> vertex ID
+		TArray<int32> VertexIDs;
+		// vertex ID -> row, or -1 for unused IDs
+		TArray<int32> VertexRows;
+		// row -> triangle ID
+		TArray<int32> TriangleIDs;
+
+		int32 NumVertices = 0;
+		int32 NumTriangles = 0;
 
-		V.resize(Mesh.MaxVertexID(), 3);
-		for (int32 vid : Mesh.VertexIndicesItr())
+		void Build(const FDynamicMesh3& Mesh)
 		{
-			FVector3d Pos = Mesh.GetVertex(vid);
-			V(vid, 0) = Pos.X;
-			V(vid, 1) = Pos.Y;
-			V(vid, 2) = Pos.Z;
+			NumVertices = Mesh.VertexCount();
+			NumTriangles = Mesh.TriangleCount();
+			bIdentity = Mesh.IsCompact();
+			VertexIDs.Reset();
+			VertexRows.Reset();
+			TriangleIDs.Reset();
+			if (bIdentity)
+			{
+				return;
+			}
+
+			VertexIDs.Reserve(NumVertices);
+			VertexRows.Init(-1, Mesh.MaxVertexID());
+			for (int32 vid : Mesh.VertexIndicesItr())
+			{
+				VertexRows[vid] = VertexIDs.Num();
+				VertexIDs.Add(vid);
+			}
+			TriangleIDs.Reserve(NumTriangles);
+			for (int32 tid : Mesh.TriangleIndicesItr())
+			{
+				TriangleIDs.Add(tid);
+			}
 		}
 
-		F.resize(Mesh.TriangleCount(), 3);
-		for (int32 tid : Mesh.TriangleIndicesItr())
+		int32 GetVertexID(int32 Row) const { return bIdentity ? Row : VertexIDs[Row]; }
+		int32 GetVertexRow(int32 VertexID) const { return bIdentity ? VertexID : VertexRows[VertexID]; }
+		int32 GetTriangleID(int32 Row) const { return bIdentity ? Row : TriangleIDs[Row]; }
+	};
+
+
+	// Convert a UE FDynamicMesh3 to libigl-style indexed triangle mesh, using a precomputed IndexMap for the mesh
+	// V is Nx3 matrix of vertex positions
+	// F is Nx3 matrix of triangle indices
+	inline void DynamicMeshToIGLMesh(const FDynamicMesh3& Mesh, const FIGLMeshIndexMap& IndexMap, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
+	{
+		// FDynamicMesh3 stores vertices and triangles in blocks, so they have to be copied rather than mapped, but rows are independent so copy in parallel
+		V.resize(IndexMap.NumVertices, 3);
+		ParallelFor(IndexMap.NumVertices, [&](int32 Row)
 		{
-			FIndex3i Tri = Mesh.GetTriangle(tid);
-			F(tid, 0) = Tri.A;
-			F(tid, 1) = Tri.B;
-			F(tid, 2) = Tri.C;
-		}
+			FVector3d Pos = Mesh.GetVertex(IndexMap.GetVertexID(Row));
+			V(Row, 0) = Pos.X;
+			V(Row, 1) = Pos.Y;
+			V(Row, 2) = Pos.Z;
+		});
+
+		F.resize(IndexMap.NumTriangles, 3);
+		ParallelFor(IndexMap.NumTriangles, [&](int32 Row)
+		{
+			FIndex3i Tri = Mesh.GetTriangle(IndexMap.GetTriangleID(Row));
+			F(Row, 0) = IndexMap.GetVertexRow(Tri.A);
+			F(Row, 1) = IndexMap.GetVertexRow(Tri.B);
+			F(Row, 2) = IndexMap.GetVertexRow(Tri.C);
+		});
 	}
 
 
-	// Copy Nx3 vertex positions from matrix V into DynamicMesh
-	void SetVertexPositions(FDynamicMesh3& Mesh, const Eigen::MatrixXd& V)
+	// Convert a UE FDynamicMesh3 to libigl-style indexed triangle mesh
+	// V is Nx3 matrix of vertex positions
+	// F is Nx3 matrix of triangle indices
+	inline void DynamicMeshToIGLMesh(const FDynamicMesh3& Mesh, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
 	{
-		check(Mesh.IsCompactV());
+		FIGLMeshIndexMap IndexMap;
+		IndexMap.Build(Mesh);
+		DynamicMeshToIGLMesh(Mesh, IndexMap, V, F);
+	}
 
-		for (int32 vid : Mesh.VertexIndicesItr())
+
+	// Copy Nx3 vertex positions from matrix V into DynamicMesh, using a precomputed IndexMap for the mesh.
+	// If MovedVerticesOut is non-null, the IDs of the vertices whose position changed are added to it.
+	inline void SetVertexPositions(FDynamicMesh3& Mesh, const FIGLMeshIndexMap& IndexMap, const Eigen::MatrixXd& V, TArray<int32>* MovedVerticesOut = nullptr)
+	{
+		check(V.rows() == IndexMap.NumVertices);
+		TArray<bool> RowMoved;
+		RowMoved.Init(false, IndexMap.NumVertices);
+		ParallelFor(IndexMap.NumVertices, [&](int32 Row)
 		{
-			FVector3d NewPos(V(vid, 0), V(vid, 1), V(vid, 2));
+			int32 vid = IndexMap.GetVertexID(Row);
+			FVector3d NewPos(V(Row, 0), V(Row, 1), V(Row, 2));
+			RowMoved[Row] = (Mesh.GetVertex(vid) != NewPos);
 			Mesh.SetVertex(vid, NewPos);
+		});
+
+		if (MovedVerticesOut != nullptr)
+		{
+			for (int32 Row = 0; Row < IndexMap.NumVertices; ++Row)
+			{
+				if (RowMoved[Row])
+				{
+					MovedVerticesOut->Add(IndexMap.GetVertexID(Row));
+				}
+			}
 		}
 	}
 
 
+	// Copy Nx3 vertex positions from matrix V into DynamicMesh
+	inline void SetVertexPositions(FDynamicMesh3& Mesh, const Eigen::MatrixXd& V)
+	{
+		FIGLMeshIndexMap IndexMap;
+		IndexMap.Build(Mesh);
+		SetVertexPositions(Mesh, IndexMap, V);
+	}
+
+
 
-}
\ No newline at end of file
+}
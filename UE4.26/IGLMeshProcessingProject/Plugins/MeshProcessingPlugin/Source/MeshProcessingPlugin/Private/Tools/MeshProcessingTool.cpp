@@ -1,6 +1,6 @@
 #include "Tools/MeshProcessingTool.h"
 #include "InteractiveToolManager.h"
-#include "MeshNormals.h"
+#include "Tools/ParallelMeshNormals.h"
 
 #define LOCTEXT_NAMESPACE "UMeshProcessingTool"
 
@@ -12,12 +12,12 @@ class FMeshProcessingOp : public FDynamicMeshOperator
 public:
 	virtual ~FMeshProcessingOp() {}
 
-	TUniqueFunction<void(FDynamicMesh3&)> MeshProcessingFunc;
+	TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MeshProcessingFunc;
 
 	FMeshProcessingOp(
 		const FDynamicMesh3& InputMesh,
 		const FTransform3d& TransformIn,
-		TUniqueFunction<void(FDynamicMesh3&)> MeshProcessingFuncIn )
+		TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MeshProcessingFuncIn )
 	{
 		ResultMesh = MakeUnique<FDynamicMesh3>(InputMesh);
 		SetResultTransform(TransformIn);
@@ -31,9 +31,10 @@ public:
 			return;
 		}
 
+		FMeshProcessingResultInfo ResultInfo;
 		if (MeshProcessingFunc)
 		{
-			MeshProcessingFunc(*ResultMesh);
+			MeshProcessingFunc(*ResultMesh, Progress, ResultInfo);
 		}
 
 		if (Progress->Cancelled())
@@ -44,9 +45,8 @@ public:
 		if (ResultMesh->HasAttributes() && ResultMesh->Attributes()->NumNormalLayers() == 1)
 		{
 			FDynamicMeshNormalOverlay* NormalsAttrib = ResultMesh->Attributes()->GetNormalLayer(0);
-			FMeshNormals Normals(&*ResultMesh);
-			Normals.RecomputeOverlayNormals(NormalsAttrib);
-			Normals.CopyToOverlay(NormalsAttrib);
+			MeshProcessingNormals::RecomputeOverlayNormals(*ResultMesh, NormalsAttrib,
+				(ResultInfo.bOnlyModifiedListedVertices) ? &ResultInfo.ModifiedVertices : nullptr);
 		}
 	}
 };
@@ -82,19 +82,21 @@ TUniquePtr<FDynamicMeshOperator> UMeshProcessingTool::MakeNewOperator()
 
 
 
-TUniqueFunction<void(FDynamicMesh3&)> UMeshProcessingTool::MakeMeshProcessingFunction()
+TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> UMeshProcessingTool::MakeMeshProcessingFunction()
 {
-	auto EditFunction = [](FDynamicMesh3& ResultMesh)
+	auto EditFunction = [](FDynamicMesh3& ResultMesh, FProgressCancel* Progress, FMeshProcessingResultInfo& ResultInfo)
 	{
-		FMeshNormals Normals(&ResultMesh);
-		Normals.ComputeVertexNormals();
+		TArray<FVector3d> Normals;
+		MeshProcessingNormals::ComputeVertexNormals(ResultMesh, Normals);
 
-		for (int32 vid : ResultMesh.VertexIndicesItr())
+		ParallelFor(ResultMesh.MaxVertexID(), [&](int32 vid)
 		{
-			FVector3d Position = ResultMesh.GetVertex(vid);
-			FVector3d Normal = Normals[vid];
-			ResultMesh.SetVertex(vid, Position + (FVector3d)Normal);
-		}
+			if (ResultMesh.IsVertex(vid))
+			{
+				FVector3d Position = ResultMesh.GetVertex(vid);
+				ResultMesh.SetVertex(vid, Position + Normals[vid]);
+			}
+		});
 	};
 
 	return MoveTemp(EditFunction);
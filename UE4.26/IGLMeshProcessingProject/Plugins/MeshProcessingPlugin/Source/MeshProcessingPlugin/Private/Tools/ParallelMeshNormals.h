@@ -0,0 +1,159 @@
+#pragma once
+#include "DynamicMesh3.h"
+#include "DynamicMeshAttributeSet.h"
+#include "IndexUtil.h"
+#include "Async/ParallelFor.h"
+
+//
+// Multithreaded normal computation for FDynamicMesh3, used to update the normals of the mesh processing results.
+// Normals are computed as a gather over the one-ring of each vertex/element, so there are no write conflicts between threads.
+//
+
+namespace MeshProcessingNormals
+{
+
+	// Area-weighted normal (ie the cross product of two triangle edges, whose length is twice the area) and internal angles of a triangle
+	inline void ComputeTriangleNormalAndAngles(const FDynamicMesh3& Mesh, int32 tid, FVector3d& AreaNormalOut, FVector3d& AnglesOut)
+	{
+		FVector3d A, B, C;
+		Mesh.GetTriVertices(tid, A, B, C);
+		AreaNormalOut = (B - A).Cross(C - A);
+		AnglesOut = FVector3d(
+			(B - A).Normalized().AngleR((C - A).Normalized()),
+			(C - B).Normalized().AngleR((A - B).Normalized()),
+			(A - C).Normalized().AngleR((B - C).Normalized()));
+	}
+
+
+	/**
+	 * Compute per-vertex normals in parallel, weighting the triangle normals by area and angle (like FMeshNormals::ComputeVertexNormals())
+	 * @param NormalsOut normals indexed by vertex ID
+	 */
+	inline void ComputeVertexNormals(const FDynamicMesh3& Mesh, TArray<FVector3d>& NormalsOut)
+	{
+		TArray<FVector3d> TriNormals, TriAngles;
+		TriNormals.SetNum(Mesh.MaxTriangleID());
+		TriAngles.SetNum(Mesh.MaxTriangleID());
+		ParallelFor(Mesh.MaxTriangleID(), [&](int32 tid)
+		{
+			if (Mesh.IsTriangle(tid))
+			{
+				ComputeTriangleNormalAndAngles(Mesh, tid, TriNormals[tid], TriAngles[tid]);
+			}
+		});
+
+		NormalsOut.SetNum(Mesh.MaxVertexID());
+		ParallelFor(Mesh.MaxVertexID(), [&](int32 vid)
+		{
+			FVector3d Normal = FVector3d::Zero();
+			if (Mesh.IsVertex(vid))
+			{
+				for (int32 tid : Mesh.VtxTrianglesItr(vid))
+				{
+					int32 j = IndexUtil::FindTriIndex(vid, Mesh.GetTriangle(tid));
+					Normal += TriAngles[tid][j] * TriNormals[tid];
+				}
+				Normal.Normalize();
+			}
+			NormalsOut[vid] = Normal;
+		});
+	}
+
+
+	/**
+	 * Recompute the element normals of a normal overlay in parallel, weighting the triangle normals by area and angle (like FMeshNormals).
+	 * First the normal and angles of all triangles are computed, and then each element sums the contributions of the triangles
+	 * around its parent vertex that it is used by.
+	 * @param ModifiedVertices if non-null, only the elements whose normals can be affected by moving these vertices are recomputed
+	 */
+	inline void RecomputeOverlayNormals(const FDynamicMesh3& Mesh, FDynamicMeshNormalOverlay* Overlay, const TArray<int32>* ModifiedVertices = nullptr)
+	{
+		TArray<FVector3d> TriNormals, TriAngles;
+		TriNormals.SetNum(Mesh.MaxTriangleID());
+		TriAngles.SetNum(Mesh.MaxTriangleID());
+
+		TArray<int32> UpdateElements;
+		if (ModifiedVertices == nullptr)
+		{
+			ParallelFor(Mesh.MaxTriangleID(), [&](int32 tid)
+			{
+				if (Mesh.IsTriangle(tid))
+				{
+					ComputeTriangleNormalAndAngles(Mesh, tid, TriNormals[tid], TriAngles[tid]);
+				}
+			});
+
+			UpdateElements.Reserve(Overlay->ElementCount());
+			for (int32 ElemID : Overlay->ElementIndicesItr())
+			{
+				UpdateElements.Add(ElemID);
+			}
+		}
+		else
+		{
+			// triangles touching a modified vertex have new normals, which changes the normals of the elements they use
+			TArray<bool> ElementMask, TriangleMask;
+			ElementMask.Init(false, Overlay->MaxElementID());
+			TriangleMask.Init(false, Mesh.MaxTriangleID());
+			for (int32 vid : *ModifiedVertices)
+			{
+				for (int32 tid : Mesh.VtxTrianglesItr(vid))
+				{
+					if (Overlay->IsSetTriangle(tid))
+					{
+						FIndex3i ElemTri = Overlay->GetTriangle(tid);
+						for (int32 j = 0; j < 3; ++j)
+						{
+							if (ElementMask[ElemTri[j]] == false)
+							{
+								ElementMask[ElemTri[j]] = true;
+								UpdateElements.Add(ElemTri[j]);
+							}
+						}
+					}
+				}
+			}
+
+			// the updated elements need the triangles around their parent vertices
+			TArray<int32> UpdateTriangles;
+			for (int32 ElemID : UpdateElements)
+			{
+				for (int32 tid : Mesh.VtxTrianglesItr(Overlay->GetParentVertex(ElemID)))
+				{
+					if (TriangleMask[tid] == false)
+					{
+						TriangleMask[tid] = true;
+						UpdateTriangles.Add(tid);
+					}
+				}
+			}
+			ParallelFor(UpdateTriangles.Num(), [&](int32 k)
+			{
+				int32 tid = UpdateTriangles[k];
+				ComputeTriangleNormalAndAngles(Mesh, tid, TriNormals[tid], TriAngles[tid]);
+			});
+		}
+
+		ParallelFor(UpdateElements.Num(), [&](int32 k)
+		{
+			int32 ElemID = UpdateElements[k];
+			FVector3d Normal = FVector3d::Zero();
+			for (int32 tid : Mesh.VtxTrianglesItr(Overlay->GetParentVertex(ElemID)))
+			{
+				if (Overlay->IsSetTriangle(tid))
+				{
+					FIndex3i ElemTri = Overlay->GetTriangle(tid);
+					for (int32 j = 0; j < 3; ++j)
+					{
+						if (ElemTri[j] == ElemID)
+						{
+							Normal += TriAngles[tid][j] * TriNormals[tid];
+						}
+					}
+				}
+			}
+			Overlay->SetElement(ElemID, (FVector3f)Normal.Normalized());
+		});
+	}
+
+}
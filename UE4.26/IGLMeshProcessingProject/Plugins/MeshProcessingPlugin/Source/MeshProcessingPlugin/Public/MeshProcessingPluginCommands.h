@@ -13,6 +13,9 @@ public:
 	//
 
     TSharedPtr<FUICommandInfo> BeginIGLSmoothingTool;
+	TSharedPtr<FUICommandInfo> BeginIGLGeodesicsTool;
+	TSharedPtr<FUICommandInfo> BeginIGLARAPTool;
+	TSharedPtr<FUICommandInfo> BeginIGLUVUnwrapTool;
 	TSharedPtr<FUICommandInfo> BeginMeshExportTool;
 
 
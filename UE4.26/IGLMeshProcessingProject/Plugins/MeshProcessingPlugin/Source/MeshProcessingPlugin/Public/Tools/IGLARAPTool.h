@@ -0,0 +1,77 @@
+#pragma once
+#include "Tools/MeshProcessingTool.h"
+#include "BaseTools/BaseMeshProcessingTool.h"
+#include "IGLARAPTool.generated.h"		// Unreal will generate this file
+
+struct FIGLARAPCache;
+
+
+// This UInteractiveToolPropertySet provides a list of settings. These settings will appear in a DetailsView panel in the Unreal Editor.
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLARAPToolProperties : public UInteractiveToolPropertySet
+{
+	GENERATED_BODY()
+public:
+	/** IDs of the vertices that stay at their initial positions */
+	UPROPERTY(EditAnywhere, Category = Constraints)
+	TArray<int> FixedVertices;
+
+	/** IDs of the vertices that are moved by HandleTranslation */
+	UPROPERTY(EditAnywhere, Category = Constraints)
+	TArray<int> HandleVertices;
+
+	/** Translation of the handle vertices, relative to the mesh size. Drag the values to deform the mesh interactively. */
+	UPROPERTY(EditAnywhere, Category = Constraints, meta = (UIMin = -1, UIMax = 1))
+	FVector HandleTranslation = FVector::ZeroVector;
+
+	/** Number of local/global iterations computed for each update. Each update starts from the previous result, so the deformation keeps converging while dragging. */
+	UPROPERTY(EditAnywhere, Category = Options, meta = (UIMin = 1, UIMax = 20, ClampMin = 1))
+	int Iterations = 5;
+};
+
+
+
+// As-Rigid-As-Possible deformation of the mesh, with the handle constraints set in the properties panel.
+// The system matrix is factorized once for each set of constrained vertices, so moving the handles only runs
+// the local/global iterations.
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLARAPTool : public UMeshProcessingTool
+{
+	GENERATED_BODY()
+public:
+
+	/*
+	 * UBaseMeshProcessingTool API overrides
+	 */
+	virtual void InitializeProperties() override;
+	virtual void OnShutdown(EToolShutdownType ShutdownType) override;
+
+	/**
+	 * This function returns a lambda that calculates a new mesh based on the input mesh (eg calls your libigl code).
+	 * UMeshProcessingTool will call this function from a background thread, inside a FDynamicMeshOperator it creates.
+	 */
+	virtual TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MakeMeshProcessingFunction() override;
+
+public:
+	// The UProperties of this object will appear in a DetailsView panel on the left-hand side of the Unreal Editor
+	UPROPERTY()
+	UIGLARAPToolProperties* ARAPProperties;
+
+protected:
+	// igl representation of the input mesh, ARAP solver for the current constraints and the previous result, shared by all the background computations
+	TSharedPtr<FIGLARAPCache, ESPMode::ThreadSafe> ARAPCache;
+};
+
+
+
+
+// The ToolBuilder implementation just creates a new instance of your UMeshProcessingTool (ie boilerplate factory pattern)
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLARAPToolBuilder : public UBaseMeshProcessingToolBuilder
+{
+	GENERATED_BODY()
+public:
+	virtual UBaseMeshProcessingTool* MakeNewToolInstance(UObject* Outer) const {
+		return NewObject<UIGLARAPTool>(Outer);
+	}
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include "Tools/MeshProcessingTool.h"
+#include "BaseTools/BaseMeshProcessingTool.h"
+#include "IGLGeodesicsTool.generated.h"		// Unreal will generate this file
+
+struct FIGLGeodesicsCache;
+
+
+// This UInteractiveToolPropertySet provides a list of settings. These settings will appear in a DetailsView panel in the Unreal Editor.
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLGeodesicsToolProperties : public UInteractiveToolPropertySet
+{
+	GENERATED_BODY()
+public:
+	/** IDs of the vertices that distances are measured from. If empty, the first vertex of the mesh is used. */
+	UPROPERTY(EditAnywhere, Category = Options)
+	TArray<int> SourceVertices;
+
+	/** Multiplier on the heat diffusion time (the squared mean edge length). Larger values give smoother distances. Changing it requires a new precomputation. */
+	UPROPERTY(EditAnywhere, Category = Options, meta = (UIMin = 0.1, UIMax = 10, ClampMin = 0.001))
+	float TimeStepScale = 1.0f;
+
+	/** Distance between the ripples displayed on the mesh, relative to the mesh size */
+	UPROPERTY(EditAnywhere, Category = Display, meta = (UIMin = 0.01, UIMax = 1, ClampMin = 0.001))
+	float RippleWavelength = 0.1f;
+
+	/** Height of the ripples displayed on the mesh, relative to the mesh size */
+	UPROPERTY(EditAnywhere, Category = Display, meta = (UIMin = 0, UIMax = 0.05))
+	float RippleAmplitude = 0.005f;
+};
+
+
+
+// Displays the geodesic distance to a set of source vertices as ripples on the mesh, computed with the Heat Method on libigl operators.
+// The heat and Poisson systems are factorized once for the input mesh and shared by all the background computations,
+// so changing the sources or the display settings only costs a back-substitution for each system.
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLGeodesicsTool : public UMeshProcessingTool
+{
+	GENERATED_BODY()
+public:
+
+	/*
+	 * UBaseMeshProcessingTool API overrides
+	 */
+	virtual void InitializeProperties() override;
+	virtual void OnShutdown(EToolShutdownType ShutdownType) override;
+
+	/**
+	 * This function returns a lambda that calculates a new mesh based on the input mesh (eg calls your libigl code).
+	 * UMeshProcessingTool will call this function from a background thread, inside a FDynamicMeshOperator it creates.
+	 */
+	virtual TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MakeMeshProcessingFunction() override;
+
+public:
+	// The UProperties of this object will appear in a DetailsView panel on the left-hand side of the Unreal Editor
+	UPROPERTY()
+	UIGLGeodesicsToolProperties* GeodesicsProperties;
+
+protected:
+	// igl representation and factorized heat geodesics systems of the input mesh, shared by all the background computations
+	TSharedPtr<FIGLGeodesicsCache, ESPMode::ThreadSafe> GeodesicsCache;
+};
+
+
+
+
+// The ToolBuilder implementation just creates a new instance of your UMeshProcessingTool (ie boilerplate factory pattern)
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLGeodesicsToolBuilder : public UBaseMeshProcessingToolBuilder
+{
+	GENERATED_BODY()
+public:
+	virtual UBaseMeshProcessingTool* MakeNewToolInstance(UObject* Outer) const {
+		return NewObject<UIGLGeodesicsTool>(Outer);
+	}
+};
@@ -3,6 +3,19 @@
 #include "BaseTools/BaseMeshProcessingTool.h"
 #include "IGLSmoothingTool.generated.h"		// Unreal will generate this file
 
+struct FIGLSmoothingCache;
+
+
+UENUM()
+enum class EIGLSmoothingSolverType : uint8
+{
+	/** Sparse Cholesky factorization. Exact, but single-threaded and its memory use grows quickly with mesh size. */
+	Direct,
+	/** Multithreaded conjugate gradient with a Jacobi preconditioner, starting from the current positions */
+	ConjugateGradient,
+	/** Multithreaded conjugate gradient preconditioned with multigrid on a hierarchy of coarsened meshes. Best for very large meshes. */
+	Multigrid
+};
 
 
 // This UInteractiveToolPropertySet provides a list of settings. These settings will appear in a DetailsView panel in the Unreal Editor.
@@ -18,6 +31,14 @@ public:
 	/** How many iterations of mesh smoothing to compute */
 	UPROPERTY(EditAnywhere, Category = Options)
 	int Iterations = 1;
+
+	/** How the linear system of each smoothing iteration is solved */
+	UPROPERTY(EditAnywhere, Category = Options)
+	EIGLSmoothingSolverType Solver = EIGLSmoothingSolverType::Direct;
+
+	/** Relative residual at which the iterative solvers stop */
+	UPROPERTY(EditAnywhere, Category = Options, meta = (ClampMin = 0, EditCondition = "Solver != EIGLSmoothingSolverType::Direct", EditConditionHides))
+	float SolverTolerance = 1e-6;
 };
 
 
@@ -39,8 +60,9 @@ public:
 	/**
 	 * This function returns a lambda that calculates a new mesh based on the input mesh (eg calls your libigl code).
 	 * UMeshProcessingTool will call this function from a background thread, inside a FDynamicMeshOperator it creates.
+	 * The lambda should check the FProgressCancel regularly, so that it stops quickly when the settings change.
 	 */
-	virtual TUniqueFunction<void(FDynamicMesh3&)> MakeMeshProcessingFunction() override;
+	virtual TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MakeMeshProcessingFunction() override;
 
 
 	/*
@@ -57,6 +79,10 @@ public:
 	// The UProperties of this object will appear in a DetailsView panel on the left-hand side of the Unreal Editor
 	UPROPERTY()
 	UIGLSmoothingToolProperties* SmoothProperties;
+
+protected:
+	// Laplacian and solver analysis of the input mesh, shared by all the background computations so they are only computed once
+	TSharedPtr<FIGLSmoothingCache, ESPMode::ThreadSafe> SmoothingCache;
 };
 
 
@@ -0,0 +1,69 @@
+#pragma once
+#include "Tools/MeshProcessingTool.h"
+#include "BaseTools/BaseMeshProcessingTool.h"
+#include "IGLUVUnwrapTool.generated.h"		// Unreal will generate this file
+
+struct FIGLUVUnwrapCache;
+
+
+// This UInteractiveToolPropertySet provides a list of settings. These settings will appear in a DetailsView panel in the Unreal Editor.
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLUVUnwrapToolProperties : public UInteractiveToolPropertySet
+{
+	GENERATED_BODY()
+public:
+	/** Maximum angle in degrees between a triangle normal and the average normal of its chart. Smaller angles give more charts with less distortion. */
+	UPROPERTY(EditAnywhere, Category = Options, meta = (UIMin = 10, UIMax = 85, ClampMin = 1, ClampMax = 89))
+	float MaxChartNormalAngle = 60.0f;
+
+	/** Space between the packed charts, as a fraction of the UV square */
+	UPROPERTY(EditAnywhere, Category = Options, meta = (UIMin = 0, UIMax = 0.05, ClampMin = 0))
+	float Gutter = 0.005f;
+};
+
+
+
+// Replaces the primary UV layer with a chart-based parameterization. The mesh is split into charts with bounded normal deviation,
+// each chart is flattened with a Least-Squares Conformal Map, and the charts are packed into the unit square.
+// The per-chart systems are independent, so they are solved in parallel.
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLUVUnwrapTool : public UMeshProcessingTool
+{
+	GENERATED_BODY()
+public:
+
+	/*
+	 * UBaseMeshProcessingTool API overrides
+	 */
+	virtual void InitializeProperties() override;
+	virtual void OnShutdown(EToolShutdownType ShutdownType) override;
+
+	/**
+	 * This function returns a lambda that calculates a new mesh based on the input mesh (eg calls your libigl code).
+	 * UMeshProcessingTool will call this function from a background thread, inside a FDynamicMeshOperator it creates.
+	 */
+	virtual TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MakeMeshProcessingFunction() override;
+
+public:
+	// The UProperties of this object will appear in a DetailsView panel on the left-hand side of the Unreal Editor
+	UPROPERTY()
+	UIGLUVUnwrapToolProperties* UVUnwrapProperties;
+
+protected:
+	// igl representation and face adjacency of the input mesh, shared by all the background computations
+	TSharedPtr<FIGLUVUnwrapCache, ESPMode::ThreadSafe> UVUnwrapCache;
+};
+
+
+
+
+// The ToolBuilder implementation just creates a new instance of your UMeshProcessingTool (ie boilerplate factory pattern)
+UCLASS()
+class MESHPROCESSINGPLUGIN_API UIGLUVUnwrapToolBuilder : public UBaseMeshProcessingToolBuilder
+{
+	GENERATED_BODY()
+public:
+	virtual UBaseMeshProcessingTool* MakeNewToolInstance(UObject* Outer) const {
+		return NewObject<UIGLUVUnwrapTool>(Outer);
+	}
+};
@@ -3,10 +3,21 @@
 #include "CoreMinimal.h"
 #include "InteractiveToolBuilder.h"
 #include "DynamicMesh3.h"
+#include "Util/ProgressCancel.h"
 #include "BaseTools/BaseMeshProcessingTool.h"
 #include "MeshProcessingTool.generated.h"
 
 
+/**
+ * Information about the modifications made by a mesh processing function, that lets UMeshProcessingTool avoid unnecessary work when updating the result.
+ */
+struct FMeshProcessingResultInfo
+{
+	/** If true, the function only moved the vertices in ModifiedVertices, so only the normals around them have to be recomputed */
+	bool bOnlyModifiedListedVertices = false;
+	TArray<int32> ModifiedVertices;
+};
+
 
 UCLASS()
 class MESHPROCESSINGPLUGIN_API UMeshProcessingToolProperties : public UInteractiveToolPropertySet
@@ -38,7 +49,12 @@ public:
 	 * UMeshProcessingTool API for subclasses to implement
 	 */
 
-	virtual TUniqueFunction<void(FDynamicMesh3&)> MakeMeshProcessingFunction();
+	/**
+	 * Returns the function that computes the result mesh in-place, on a background thread. Long computations should check
+	 * the FProgressCancel (which may be null) regularly and return early if it is cancelled, as the result is discarded then.
+	 * The function can describe the modifications it made in the FMeshProcessingResultInfo.
+	 */
+	virtual TUniqueFunction<void(FDynamicMesh3&, FProgressCancel*, FMeshProcessingResultInfo&)> MakeMeshProcessingFunction();
 
 protected:
 	UPROPERTY()
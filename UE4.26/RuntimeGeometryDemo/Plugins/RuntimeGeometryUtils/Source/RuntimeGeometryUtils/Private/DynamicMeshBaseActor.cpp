@@ -4,13 +4,24 @@
 #include "Generators/GridBoxMeshGenerator.h"
 #include "MeshQueries.h"
 #include "DynamicMesh3.h"
-#include "MeshNormals.h"
 #include "MeshTransforms.h"
 #include "MeshSimplification.h"
+#include "QueueRemesher.h"
 #include "Operations/MeshBoolean.h"
 #include "Implicit/Solidify.h"
+#include "Implicit/Morphology.h"
 
 #include "DynamicMeshOBJReader.h"
+#include "MeshBooleanRuntimeUtils.h"
+#include "SparseImplicitRuntimeUtils.h"
+#include "MeshPatchRuntimeUtils.h"
+#include "MeshNormalsRuntimeUtils.h"
+#include "MeshUVRuntimeUtils.h"
+#include "MeshFieldRuntimeUtils.h"
+#include "PrimitiveMeshCache.h"
+#include "ImportedMeshCache.h"
+
+#include "HAL/FileManager.h"
 
 // Sets default values
 ADynamicMeshBaseActor::ADynamicMeshBaseActor()
@@ -27,13 +38,13 @@ ADynamicMeshBaseActor::ADynamicMeshBaseActor()
 void ADynamicMeshBaseActor::PostLoad()
 {
 	Super::PostLoad();
-	OnMeshGenerationSettingsModified();
+	RegenerateSourceMeshIfOutdated();
 }
 
 void ADynamicMeshBaseActor::PostActorCreated()
 {
 	Super::PostActorCreated();
-	OnMeshGenerationSettingsModified();
+	RegenerateSourceMeshIfOutdated();
 }
 
 
@@ -44,7 +55,7 @@ void ADynamicMeshBaseActor::BeginPlay()
 	Super::BeginPlay();
 	
 	AccumulatedTime = 0;
-	OnMeshGenerationSettingsModified();
+	RegenerateSourceMeshIfOutdated();
 }
 
 // Called every frame
@@ -55,7 +66,10 @@ void ADynamicMeshBaseActor::Tick(float DeltaTime)
 	AccumulatedTime += DeltaTime;
 	if (bRegenerateOnTick && SourceType == EDynamicMeshActorSourceType::Primitive)
 	{
-		OnMeshGenerationSettingsModified();
+		if (RescaleGeneratedPrimitive() == false)
+		{
+			OnMeshGenerationSettingsModified();
+		}
 	}
 }
 
@@ -71,30 +85,118 @@ void ADynamicMeshBaseActor::PostEditChangeProperty(FPropertyChangedEvent& Proper
 
 void ADynamicMeshBaseActor::EditMesh(TFunctionRef<void(FDynamicMesh3&)> EditFunc)
 {
+	// EditFunc may use the spatial data structures of the shared mesh, so keep it alive until EditFunc is done
+	TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> PrevSharedMesh = SharedSourceMesh;
+	ForkSharedSourceMesh();
 	EditFunc(SourceMesh);
+	UpdateSourceMeshCaches();
+	OnMeshEditedInternal();
+}
+
+
+void ADynamicMeshBaseActor::EditMeshPositions(TFunctionRef<void(FDynamicMesh3&)> EditFunc, bool bNormalsModified)
+{
+	TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> PrevSharedMesh = SharedSourceMesh;
+	ForkSharedSourceMesh();
+	EditFunc(SourceMesh);
+	UpdateSourceMeshCaches();
+	OnMeshPositionsEditedInternal(bNormalsModified);
+}
 
-	// update spatial data structures
-	if (bEnableSpatialQueries || bEnableInsideQueries)
-	{
-		MeshAABBTree.Build();
-		if (bEnableInsideQueries)
-		{
-			FastWinding->Build();
-		}
-	}
 
+void ADynamicMeshBaseActor::UpdateSourceMeshCaches()
+{
+	SourceMeshEditCount++;
+
+	// discard compact copy, it is rebuilt on demand
+	CompactFastWinding.Reset();
+	CompactMeshAABBTree.Reset();
+	CompactSourceMesh.Reset();
+
+	// The spatial data structures are out-of-date now (their edit counts no longer match SourceMeshEditCount), they are rebuilt by
+	// BuildSourceSpatial() when they are next queried. So repeated edits without queries in between, eg EditMeshPositions()
+	// on every Tick, do not rebuild them each time. The mesh timestamps cannot be used for this, as an edit can replace SourceMesh
+	// with another mesh whose timestamp happens to match the one the trees were built at.
+}
+
+
+void ADynamicMeshBaseActor::SetSharedSourceMesh(TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> SharedMesh)
+{
+	SharedSourceMesh = SharedMesh;
+	SourceMesh = FDynamicMesh3();
+	UpdateSourceMeshCaches();
 	OnMeshEditedInternal();
 }
 
 
+void ADynamicMeshBaseActor::ForkSharedSourceMesh()
+{
+	if (SharedSourceMesh.IsValid())
+	{
+		SourceMesh = SharedSourceMesh->Mesh;
+		SharedSourceMesh.Reset();
+		// make sure the trees of the previous SourceMesh are not mistaken for trees of the copy
+		MeshAABBTree.SetMesh(&SourceMesh, false);
+	}
+}
+
+
 void ADynamicMeshBaseActor::GetMeshCopy(FDynamicMesh3& MeshOut)
 {
-	MeshOut = SourceMesh;
+	MeshOut = GetMeshRef();
 }
 
 const FDynamicMesh3& ADynamicMeshBaseActor::GetMeshRef() const
 {
-	return SourceMesh;
+	return (SharedSourceMesh.IsValid()) ? SharedSourceMesh->Mesh : SourceMesh;
+}
+
+FDynamicMeshAABBTree3& ADynamicMeshBaseActor::GetSourceSpatial()
+{
+	return (SharedSourceMesh.IsValid()) ? SharedSourceMesh->AABBTree : MeshAABBTree;
+}
+
+TFastWindingTree<FDynamicMesh3>& ADynamicMeshBaseActor::GetSourceFastWinding()
+{
+	return (SharedSourceMesh.IsValid()) ? SharedSourceMesh->FastWinding : *FastWinding;
+}
+
+void ADynamicMeshBaseActor::BuildSourceSpatial(bool bBuildFastWinding)
+{
+	// The trees of a shared mesh are only built once, by the first Actor that needs them
+	if (SharedSourceMesh.IsValid())
+	{
+		SharedSourceMesh->BuildSpatial(bBuildFastWinding);
+		return;
+	}
+	if (SpatialEditCount != SourceMeshEditCount)
+	{
+		MeshAABBTree.Build();
+		SpatialEditCount = SourceMeshEditCount;
+	}
+	if (bBuildFastWinding && FastWindingEditCount != SourceMeshEditCount)
+	{
+		FastWinding->Build();
+		FastWindingEditCount = SourceMeshEditCount;
+	}
+}
+
+FDynamicMeshAABBTree3* ADynamicMeshBaseActor::GetCachedSpatial()
+{
+	if (SharedSourceMesh.IsValid())
+	{
+		return (SharedSourceMesh->AABBTree.IsValid()) ? &SharedSourceMesh->AABBTree : nullptr;
+	}
+	return (SpatialEditCount == SourceMeshEditCount) ? &MeshAABBTree : nullptr;
+}
+
+TFastWindingTree<FDynamicMesh3>* ADynamicMeshBaseActor::GetCachedFastWinding()
+{
+	if (SharedSourceMesh.IsValid())
+	{
+		return (SharedSourceMesh->AABBTree.IsValid() && SharedSourceMesh->FastWinding.IsBuilt()) ? &SharedSourceMesh->FastWinding : nullptr;
+	}
+	return (SpatialEditCount == SourceMeshEditCount && FastWindingEditCount == SourceMeshEditCount) ? FastWinding.Get() : nullptr;
 }
 
 void ADynamicMeshBaseActor::OnMeshEditedInternal()
@@ -102,12 +204,90 @@ void ADynamicMeshBaseActor::OnMeshEditedInternal()
 	OnMeshModified.Broadcast(this);
 }
 
+void ADynamicMeshBaseActor::OnMeshPositionsEditedInternal(bool bNormalsModified)
+{
+	OnMeshEditedInternal();
+}
+
 
 void ADynamicMeshBaseActor::OnMeshGenerationSettingsModified()
 {
+	GeneratedPrimitive.bValid = false;
+	GeneratedPrimitive.Template.Reset();
+	if (SourceType == EDynamicMeshActorSourceType::ImportedMesh)
+	{
+		// the imported mesh is shared with the other Actors that import the same file with the same settings
+		SetSharedSourceMesh(FindOrImportSharedMesh());
+		return;
+	}
 	EditMesh([this](FDynamicMesh3& MeshToUpdate) {
 		RegenerateSourceMesh(MeshToUpdate);
 	});
+	GeneratedPrimitive.EditCount = SourceMeshEditCount;
+}
+
+
+void ADynamicMeshBaseActor::RegenerateSourceMeshIfOutdated()
+{
+	// the primitive is usually already generated by PostLoad() or PostActorCreated() by the time BeginPlay() is called
+	if (IsGeneratedPrimitiveTopologyCurrent() && GeneratedPrimitive.Radius == GetPrimitiveRadius())
+	{
+		return;
+	}
+	OnMeshGenerationSettingsModified();
+}
+
+
+bool ADynamicMeshBaseActor::IsGeneratedPrimitiveTopologyCurrent() const
+{
+	const FGeneratedPrimitiveInfo& Info = GeneratedPrimitive;
+	return SourceType == EDynamicMeshActorSourceType::Primitive
+		&& Info.bValid && Info.EditCount == SourceMeshEditCount
+		&& Info.PrimitiveType == PrimitiveType && Info.NormalsMode == NormalsMode
+		&& Info.TessellationLevel == TessellationLevel && Info.BoxDepthRatio == BoxDepthRatio;
+}
+
+
+double ADynamicMeshBaseActor::GetPrimitiveRadius() const
+{
+	return (this->MinimumRadius + this->VariableRadius)
+		+ (this->VariableRadius) * FMathd::Sin(PulseSpeed * AccumulatedTime);
+}
+
+
+bool ADynamicMeshBaseActor::RescaleGeneratedPrimitive()
+{
+	if (IsGeneratedPrimitiveTopologyCurrent() == false)
+	{
+		return false;
+	}
+
+	// the primitives are centered at the origin and their vertices scale linearly with the radius
+	const FGeneratedPrimitiveInfo& Info = GeneratedPrimitive;
+	double NewRadius = GetPrimitiveRadius();
+	if (Info.Radius < FMathd::ZeroTolerance || NewRadius < FMathd::ZeroTolerance)
+	{
+		return false;
+	}
+	// scale the template rather than the current positions, so that round-off does not accumulate over many frames
+	const FDynamicMesh3* Template = Info.Template.Get();
+	if (Template == nullptr || Template->MaxVertexID() != GetMeshRef().MaxVertexID())
+	{
+		return false;
+	}
+
+	// uniform scaling does not change the normals
+	EditMeshPositions([Template, NewRadius](FDynamicMesh3& MeshToUpdate)
+	{
+		for (int32 vid : MeshToUpdate.VertexIndicesItr())
+		{
+			MeshToUpdate.SetVertex(vid, NewRadius * Template->GetVertex(vid));
+		}
+	}, false);
+
+	GeneratedPrimitive.Radius = NewRadius;
+	GeneratedPrimitive.EditCount = SourceMeshEditCount;
+	return true;
 }
 
 
@@ -115,56 +295,106 @@ void ADynamicMeshBaseActor::RegenerateSourceMesh(FDynamicMesh3& MeshOut)
 {
 	if (SourceType == EDynamicMeshActorSourceType::Primitive)
 	{
-		double UseRadius = (this->MinimumRadius + this->VariableRadius)
-			+ (this->VariableRadius) * FMathd::Sin(PulseSpeed * AccumulatedTime);
+		double UseRadius = GetPrimitiveRadius();
 
-		// generate new mesh
+		// Unit-size primitive meshes are generated once and shared by all Actors via the template cache,
+		// each Actor copies the template and scales it to its radius
+		RTGUtils::FPrimitiveTemplateKey TemplateKey;
+		TemplateKey.PrimitiveType = (int32)this->PrimitiveType;
+		TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe> TemplateMesh;
 		if (this->PrimitiveType == EDynamicMeshActorPrimitiveType::Sphere)
 		{
-			FSphereGenerator SphereGen;
-			SphereGen.NumPhi = SphereGen.NumTheta = FMath::Clamp(this->TessellationLevel, 3, 50);
-			SphereGen.Radius = UseRadius;
-			MeshOut.Copy(&SphereGen.Generate());
+			TemplateKey.TessellationLevel = FMath::Clamp(this->TessellationLevel, 3, 50);
+			TemplateMesh = RTGUtils::FindOrAddPrimitiveTemplate(TemplateKey, [&TemplateKey](FDynamicMesh3& Mesh)
+			{
+				FSphereGenerator SphereGen;
+				SphereGen.NumPhi = SphereGen.NumTheta = TemplateKey.TessellationLevel;
+				SphereGen.Radius = 1.0;
+				Mesh.Copy(&SphereGen.Generate());
+			});
 		}
 		else
 		{
-			FGridBoxMeshGenerator BoxGen;
-			int TessLevel = FMath::Clamp(this->TessellationLevel, 2, 50);
-			BoxGen.EdgeVertices = FIndex3i(TessLevel, TessLevel, TessLevel);
-			FVector3d BoxExtents = UseRadius * FVector3d::One();
-			BoxExtents.Z *= BoxDepthRatio;
-			BoxGen.Box = FOrientedBox3d(FVector3d::Zero(), BoxExtents);
-			MeshOut.Copy(&BoxGen.Generate());
+			TemplateKey.TessellationLevel = FMath::Clamp(this->TessellationLevel, 2, 50);
+			TemplateKey.Extents = FVector3d(1.0, 1.0, BoxDepthRatio);
+			TemplateMesh = RTGUtils::FindOrAddPrimitiveTemplate(TemplateKey, [&TemplateKey](FDynamicMesh3& Mesh)
+			{
+				FGridBoxMeshGenerator BoxGen;
+				int TessLevel = TemplateKey.TessellationLevel;
+				BoxGen.EdgeVertices = FIndex3i(TessLevel, TessLevel, TessLevel);
+				BoxGen.Box = FOrientedBox3d(FVector3d::Zero(), TemplateKey.Extents);
+				Mesh.Copy(&BoxGen.Generate());
+			});
+		}
+
+		MeshOut.Copy(*TemplateMesh);
+		for (int32 vid : MeshOut.VertexIndicesItr())
+		{
+			MeshOut.SetVertex(vid, UseRadius * MeshOut.GetVertex(vid));
 		}
 
+		GeneratedPrimitive.bValid = true;
+		GeneratedPrimitive.PrimitiveType = PrimitiveType;
+		GeneratedPrimitive.NormalsMode = NormalsMode;
+		GeneratedPrimitive.TessellationLevel = TessellationLevel;
+		GeneratedPrimitive.BoxDepthRatio = BoxDepthRatio;
+		GeneratedPrimitive.Radius = UseRadius;
+		GeneratedPrimitive.Template = TemplateMesh;
+
+		RecomputeNormals(MeshOut);
 	} 
 	else if (SourceType == EDynamicMeshActorSourceType::ImportedMesh)
 	{
-		FString UsePath = ImportPath;
-		if (FPaths::FileExists(UsePath) == false && FPaths::IsRelative(UsePath))
-		{
-			UsePath = FPaths::ProjectContentDir() + ImportPath;
-		}
+		MeshOut = FindOrImportSharedMesh()->Mesh;
+	}
+}
 
-		MeshOut = FDynamicMesh3();
-		if ( ! RTGUtils::ReadOBJMesh(UsePath, MeshOut, true, true, true, bReverseOrientation))
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Error reading mesh file %s"), *UsePath);
-			FSphereGenerator SphereGen;
-			SphereGen.NumPhi = SphereGen.NumTheta = 8;
-			SphereGen.Radius = this->MinimumRadius;
-			MeshOut.Copy(&SphereGen.Generate());
-		}
 
-		if (bCenterPivot)
-		{
-			MeshTransforms::Translate(MeshOut, -MeshOut.GetBounds().Center());
-		}
+TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> ADynamicMeshBaseActor::FindOrImportSharedMesh()
+{
+	FString UsePath = ImportPath;
+	if (FPaths::FileExists(UsePath) == false && FPaths::IsRelative(UsePath))
+	{
+		UsePath = FPaths::ProjectContentDir() + ImportPath;
+	}
 
-		if (ImportScale != 1.0)
-		{
-			MeshTransforms::Scale(MeshOut, ImportScale*FVector3d::One(), FVector3d::Zero());
-		}
+	RTGUtils::FImportedMeshKey Key;
+	Key.Path = FPaths::ConvertRelativePathToFull(UsePath);
+	FFileStatData FileStats = IFileManager::Get().GetStatData(*UsePath);
+	Key.FileTimestamp = FileStats.ModificationTime;
+	Key.FileSize = FileStats.FileSize;
+	Key.bReverseOrientation = bReverseOrientation;
+	Key.bCenterPivot = bCenterPivot;
+	Key.ImportScale = ImportScale;
+	Key.NormalsMode = (int32)NormalsMode;
+
+	return RTGUtils::FindOrAddImportedMesh(Key, [&](FDynamicMesh3& MeshOut)
+	{
+		ImportSourceMesh(UsePath, MeshOut);
+	});
+}
+
+
+void ADynamicMeshBaseActor::ImportSourceMesh(const FString& UsePath, FDynamicMesh3& MeshOut)
+{
+	MeshOut = FDynamicMesh3();
+	if ( ! RTGUtils::ReadOBJMesh(UsePath, MeshOut, true, true, true, bReverseOrientation))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Error reading mesh file %s"), *UsePath);
+		FSphereGenerator SphereGen;
+		SphereGen.NumPhi = SphereGen.NumTheta = 8;
+		SphereGen.Radius = this->MinimumRadius;
+		MeshOut.Copy(&SphereGen.Generate());
+	}
+
+	if (bCenterPivot)
+	{
+		MeshTransforms::Translate(MeshOut, -MeshOut.GetBounds().Center());
+	}
+
+	if (ImportScale != 1.0)
+	{
+		MeshTransforms::Scale(MeshOut, ImportScale*FVector3d::One(), FVector3d::Zero());
 	}
 
 	RecomputeNormals(MeshOut);
@@ -181,12 +411,12 @@ void ADynamicMeshBaseActor::RecomputeNormals(FDynamicMesh3& MeshOut)
 	if (this->NormalsMode == EDynamicMeshActorNormalsMode::PerVertexNormals)
 	{
 		MeshOut.EnableAttributes();
-		FMeshNormals::InitializeOverlayToPerVertexNormals(MeshOut.Attributes()->PrimaryNormals(), false);
+		RTGUtils::InitializeOverlayToPerVertexNormals(MeshOut.Attributes()->PrimaryNormals());
 	}
 	else if (this->NormalsMode == EDynamicMeshActorNormalsMode::FaceNormals)
 	{
 		MeshOut.EnableAttributes();
-		FMeshNormals::InitializeOverlayToPerTriangleNormals(MeshOut.Attributes()->PrimaryNormals());
+		RTGUtils::InitializeOverlayToPerTriangleNormals(MeshOut.Attributes()->PrimaryNormals());
 	}
 }
 
@@ -194,7 +424,7 @@ void ADynamicMeshBaseActor::RecomputeNormals(FDynamicMesh3& MeshOut)
 
 int ADynamicMeshBaseActor::GetTriangleCount()
 {
-	return SourceMesh.TriangleCount();
+	return GetMeshRef().TriangleCount();
 }
 
 
@@ -206,18 +436,19 @@ float ADynamicMeshBaseActor::DistanceToPoint(FVector WorldPoint, FVector& Neares
 	{
 		return TNumericLimits<float>::Max();
 	}
+	BuildSourceSpatial(false);
 
 	FTransform3d ActorToWorld(GetActorTransform());
 	FVector3d LocalPoint = ActorToWorld.InverseTransformPosition((FVector3d)WorldPoint);
 
 	double NearDistSqr;
-	NearestTriangle = MeshAABBTree.FindNearestTriangle(LocalPoint, NearDistSqr);
+	NearestTriangle = GetSourceSpatial().FindNearestTriangle(LocalPoint, NearDistSqr);
 	if (NearestTriangle < 0)
 	{
 		return TNumericLimits<float>::Max();
 	}
 
-	FDistPoint3Triangle3d DistQuery = TMeshQueries<FDynamicMesh3>::TriangleDistance(SourceMesh, NearestTriangle, LocalPoint);
+	FDistPoint3Triangle3d DistQuery = TMeshQueries<FDynamicMesh3>::TriangleDistance(GetMeshRef(), NearestTriangle, LocalPoint);
 	NearestWorldPoint = (FVector)ActorToWorld.TransformPosition(DistQuery.ClosestTrianglePoint);
 	TriBaryCoords = (FVector)DistQuery.TriangleBaryCoords;
 	return (float)FMathd::Sqrt(NearDistSqr);
@@ -228,9 +459,10 @@ FVector ADynamicMeshBaseActor::NearestPoint(FVector WorldPoint)
 {
 	if (bEnableSpatialQueries)
 	{
+		BuildSourceSpatial(false);
 		FTransform3d ActorToWorld(GetActorTransform());
 		FVector3d LocalPoint = ActorToWorld.InverseTransformPosition((FVector3d)WorldPoint);
-		return (FVector)ActorToWorld.TransformPosition(MeshAABBTree.FindNearestPoint(LocalPoint));
+		return (FVector)ActorToWorld.TransformPosition(GetSourceSpatial().FindNearestPoint(LocalPoint));
 	}
 	return WorldPoint;
 }
@@ -239,20 +471,41 @@ bool ADynamicMeshBaseActor::ContainsPoint(FVector WorldPoint, float WindingThres
 {
 	if (bEnableInsideQueries)
 	{
+		BuildSourceSpatial(true);
 		FTransform3d ActorToWorld(GetActorTransform());
 		FVector3d LocalPoint = ActorToWorld.InverseTransformPosition((FVector3d)WorldPoint);
-		return FastWinding->IsInside(LocalPoint, WindingThreshold);
+		return GetSourceFastWinding().IsInside(LocalPoint, WindingThreshold);
 	}
 	return false;
 }
 
 
+void ADynamicMeshBaseActor::SampleSignedDistanceGrid(int VoxelResolution, int ExtendCells, TArray<float>& DistancesOut, FVector& GridOrigin, float& CellSize, FIntVector& Dimensions, float WindingThreshold)
+{
+	BuildSourceSpatial();
+	FDynamicMeshAABBTree3& Spatial = GetSourceSpatial();
+	FAxisAlignedBox3d Bounds = Spatial.GetBoundingBox();
+	double UseCellSize = FMathd::Max(Bounds.MaxDim() / (double)FMath::Max(VoxelResolution, 1), FMathf::ZeroTolerance);
+	Bounds.Expand((double)FMath::Max(ExtendCells, 0) * UseCellSize);
+
+	RTGUtils::FDenseFieldGrid Grid;
+	Grid.Initialize(Bounds, UseCellSize);
+	RTGUtils::SampleSignedDistance(Spatial, GetSourceFastWinding(), Grid, WindingThreshold);
+
+	DistancesOut = MoveTemp(Grid.Values);
+	GridOrigin = (FVector)Grid.Origin;
+	CellSize = (float)Grid.CellSize;
+	Dimensions = FIntVector(Grid.Dimensions.X, Grid.Dimensions.Y, Grid.Dimensions.Z);
+}
+
+
 bool ADynamicMeshBaseActor::IntersectRay(FVector RayOrigin, FVector RayDirection, 
 	FVector& WorldHitPoint, float& HitDistance, int& NearestTriangle, FVector& TriBaryCoords,
 	float MaxDistance)
 {
 	if (bEnableSpatialQueries)
 	{
+		BuildSourceSpatial(false);
 		FTransform3d ActorToWorld(GetActorTransform());
 		FVector3d WorldDirection(RayDirection); WorldDirection.Normalize();
 		FRay3d LocalRay(ActorToWorld.InverseTransformPosition((FVector3d)RayOrigin),
@@ -262,10 +515,11 @@ bool ADynamicMeshBaseActor::IntersectRay(FVector RayOrigin, FVector RayDirection
 		{
 			QueryOptions.MaxDistance = MaxDistance;
 		}
-		NearestTriangle = MeshAABBTree.FindNearestHitTriangle(LocalRay, QueryOptions);
-		if (SourceMesh.IsTriangle(NearestTriangle))
+		const FDynamicMesh3& Mesh = GetMeshRef();
+		NearestTriangle = GetSourceSpatial().FindNearestHitTriangle(LocalRay, QueryOptions);
+		if (Mesh.IsTriangle(NearestTriangle))
 		{
-			FIntrRay3Triangle3d IntrQuery = TMeshQueries<FDynamicMesh3>::TriangleIntersection(SourceMesh, NearestTriangle, LocalRay);
+			FIntrRay3Triangle3d IntrQuery = TMeshQueries<FDynamicMesh3>::TriangleIntersection(Mesh, NearestTriangle, LocalRay);
 			if (IntrQuery.IntersectionType == EIntersectionType::Point)
 			{
 				HitDistance = IntrQuery.RayParameter;
@@ -295,38 +549,165 @@ void ADynamicMeshBaseActor::IntersectWithMesh(ADynamicMeshBaseActor* OtherMeshAc
 }
 
 
+static FMeshBoolean::EBooleanOp GetMeshBooleanOp(EDynamicMeshActorBooleanOperation Operation)
+{
+	switch (Operation)
+	{
+		default:
+			return FMeshBoolean::EBooleanOp::Union;
+		case EDynamicMeshActorBooleanOperation::Subtraction:
+			return FMeshBoolean::EBooleanOp::Difference;
+		case EDynamicMeshActorBooleanOperation::Intersection:
+			return FMeshBoolean::EBooleanOp::Intersect;
+	}
+}
+
+
+/**
+ * Get the mesh of OtherActor and the transform that maps it into the local space of Actor, for the Boolean operations.
+ * FMeshBoolean applies the transform internally, so usually the mesh of OtherActor can be used without copying it.
+ * But a single transform cannot represent the combination of a non-uniform scale with a rotation exactly, so if either Actor
+ * has a non-uniform scale, a copy of the mesh is mapped into local space via world space instead, and the transform is the identity.
+ * @return the mesh of OtherActor, or LocalCopyStorage if the mesh had to be copied
+ */
+static const FDynamicMesh3& GetMeshForBoolean(const AActor* Actor, const ADynamicMeshBaseActor* OtherActor, FDynamicMesh3& LocalCopyStorage, FTransform3d& OtherToLocalOut)
+{
+	FTransform LocalToWorld = Actor->GetActorTransform();
+	FTransform OtherToWorld = OtherActor->GetActorTransform();
+	if (LocalToWorld.GetScale3D().AllComponentsEqual() && OtherToWorld.GetScale3D().AllComponentsEqual())
+	{
+		OtherToLocalOut = FTransform3d(OtherToWorld.GetRelativeTransform(LocalToWorld));
+		return OtherActor->GetMeshRef();
+	}
+
+	LocalCopyStorage.Copy(OtherActor->GetMeshRef());
+	MeshTransforms::ApplyTransform(LocalCopyStorage, FTransform3d(OtherToWorld));
+	MeshTransforms::ApplyTransformInverse(LocalCopyStorage, FTransform3d(LocalToWorld));
+	OtherToLocalOut = FTransform3d::Identity();
+	return LocalCopyStorage;
+}
+
+
 void ADynamicMeshBaseActor::BooleanWithMesh(ADynamicMeshBaseActor* OtherMeshActor, EDynamicMeshActorBooleanOperation Operation)
 {
-	if (ensure(OtherMeshActor) == false) return;
+	if (ensure(OtherMeshActor) == false || OtherMeshActor == this) return;
+
+	FDynamicMesh3 LocalCopy;
+	FTransform3d OtherToLocal;
+	const FDynamicMesh3& OtherMesh = GetMeshForBoolean(this, OtherMeshActor, LocalCopy, OtherToLocal);
+	// the cached tree of the other Actor is only valid for its untransformed mesh
+	FDynamicMeshAABBTree3* OtherSpatial = (&OtherMesh == &LocalCopy) ? nullptr : OtherMeshActor->GetCachedSpatial();
+	BooleanWithMeshInternal(OtherMesh, OtherToLocal, OtherSpatial, Operation);
+}
 
-	FTransform3d ActorToWorld(GetActorTransform());
-	FTransform3d OtherToWorld(OtherMeshActor->GetActorTransform());
 
-	FDynamicMesh3 OtherMesh;
-	OtherMeshActor->GetMeshCopy(OtherMesh);
-	MeshTransforms::ApplyTransform(OtherMesh, OtherToWorld);
-	MeshTransforms::ApplyTransformInverse(OtherMesh, ActorToWorld);
+void ADynamicMeshBaseActor::BooleanWithMeshes(const TArray<ADynamicMeshBaseActor*>& OtherMeshActors, EDynamicMeshActorBooleanOperation Operation)
+{
+	TArray<const FDynamicMesh3*> OtherMeshes;
+	TArray<FTransform3d> OtherToLocal;
+	TArray<ADynamicMeshBaseActor*> OtherActors;
+	TArray<TUniquePtr<FDynamicMesh3>> LocalCopies;
+	for (ADynamicMeshBaseActor* OtherMeshActor : OtherMeshActors)
+	{
+		if (OtherMeshActor != nullptr && OtherMeshActor != this)
+		{
+			TUniquePtr<FDynamicMesh3> LocalCopy = MakeUnique<FDynamicMesh3>();
+			FTransform3d Transform;
+			OtherMeshes.Add(&GetMeshForBoolean(this, OtherMeshActor, *LocalCopy, Transform));
+			OtherToLocal.Add(Transform);
+			OtherActors.Add(OtherMeshActor);
+			if (OtherMeshes.Last() == LocalCopy.Get())
+			{
+				LocalCopies.Add(MoveTemp(LocalCopy));
+			}
+		}
+	}
 
-	EditMesh([&](FDynamicMesh3& MeshToUpdate) {
+	if (OtherMeshes.Num() == 0)
+	{
+		return;
+	}
+	if (OtherMeshes.Num() == 1)
+	{
+		// the cached tree of the other Actor is only valid for its untransformed mesh
+		bool bIsLocalCopy = (LocalCopies.Num() > 0);
+		FDynamicMeshAABBTree3* OtherSpatial = (bIsLocalCopy) ? nullptr : OtherActors[0]->GetCachedSpatial();
+		BooleanWithMeshInternal(*OtherMeshes[0], OtherToLocal[0], OtherSpatial, Operation);
+		return;
+	}
 
-		FDynamicMesh3 ResultMesh;
+	// A - B - C = A - (B + C), and A * B * C = A * (B * C), so only the combined tool mesh needs to be applied to SourceMesh
+	FMeshBoolean::EBooleanOp CombineOp = (Operation == EDynamicMeshActorBooleanOperation::Intersection) ?
+		FMeshBoolean::EBooleanOp::Intersect : FMeshBoolean::EBooleanOp::Union;
+	FDynamicMesh3 CombinedMesh;
+	bool bCombinedOK = RTGUtils::CombineMeshesWithBoolean(OtherMeshes, OtherToLocal, CombineOp, CombinedMesh);
+	if (!bCombinedOK)
+	{
+		// the combined tool mesh may have cracks, which would open holes in SourceMesh, so it is not applied
+		UE_LOG(LogTemp, Warning, TEXT("Combining %d meshes for a Boolean failed, the Boolean was skipped"), OtherMeshes.Num());
+		return;
+	}
+
+	BooleanWithMeshInternal(CombinedMesh, FTransform3d::Identity(), nullptr, Operation);
+}
+
+
+void ADynamicMeshBaseActor::BooleanWithMeshInternal(const FDynamicMesh3& OtherMesh, const FTransform3d& OtherToLocal, FDynamicMeshAABBTree3* OtherSpatial, EDynamicMeshActorBooleanOperation Operation)
+{
+	FMeshBoolean::EBooleanOp ApplyOp = GetMeshBooleanOp(Operation);
+
+	// an Intersection discards everything outside OtherMesh, so it cannot be done locally
+	if (BooleanMode != EDynamicMeshActorBooleanMode::Exact && ApplyOp != FMeshBoolean::EBooleanOp::Intersect)
+	{
+		// if SourceMesh is shared, these are the trees of the shared mesh, which are still valid for the private copy created by EditMesh()
+		BuildSourceSpatial();
+		FDynamicMeshAABBTree3& Spatial = GetSourceSpatial();
+		TFastWindingTree<FDynamicMesh3>& Winding = GetSourceFastWinding();
 
-		FMeshBoolean::EBooleanOp ApplyOp = FMeshBoolean::EBooleanOp::Union;
-		switch (Operation)
+		TArray<int32> NewTriangles;
+		if (BooleanMode == EDynamicMeshActorBooleanMode::VoxelLocalRegion)
 		{
-			default:
-				break;
-			case EDynamicMeshActorBooleanOperation::Subtraction:
-				ApplyOp = FMeshBoolean::EBooleanOp::Difference;
-				break;
-			case EDynamicMeshActorBooleanOperation::Intersection:
-				ApplyOp = FMeshBoolean::EBooleanOp::Intersect;
-				break;
+			// the patch is computed from the current mesh before editing, so if the Boolean is skipped SourceMesh is not forked or rebuilt
+			RTGUtils::FLocalizedVoxelBooleanPatch Patch;
+			bool bOK = RTGUtils::ComputeLocalizedVoxelBooleanPatch(GetMeshRef(), Spatial, Winding,
+				OtherMesh, OtherToLocal, ApplyOp, Patch, VoxelBooleanResolution, VoxelBooleanTimeBudget, LocalRegionExpansion);
+			if (!bOK)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Voxel Boolean exceeded the resolution or time budget and was skipped"));
+				return;
+			}
+
+			EditMesh([&](FDynamicMesh3& MeshToUpdate) {
+				RTGUtils::ApplyLocalizedVoxelBooleanPatch(MeshToUpdate, Patch, &NewTriangles);
+				RecomputeNormals(MeshToUpdate);
+			});
+			SetLastEditTriangles(MoveTemp(NewTriangles));
+			return;
 		}
 
+		EditMesh([&](FDynamicMesh3& MeshToUpdate) {
+			bool bOK = RTGUtils::ComputeLocalizedBoolean(MeshToUpdate, Spatial, Winding,
+				OtherMesh, OtherToLocal, ApplyOp, LocalRegionExpansion, OtherSpatial, &NewTriangles);
+			if (!bOK)
+			{
+				// fill holes
+				RTGUtils::FillHolesAroundTriangles(MeshToUpdate, NewTriangles);
+			}
+
+			RecomputeNormals(MeshToUpdate);
+		});
+		SetLastEditTriangles(MoveTemp(NewTriangles));
+		return;
+	}
+
+	TArray<int32> NewTriangles;
+	EditMesh([&](FDynamicMesh3& MeshToUpdate) {
+
+		FDynamicMesh3 ResultMesh;
+
 		FMeshBoolean Boolean(
 			&MeshToUpdate, FTransform3d::Identity(),
-			&OtherMesh, FTransform3d::Identity(),
+			&OtherMesh, OtherToLocal,
 			&ResultMesh,
 			ApplyOp);
 		Boolean.bPutResultInInputSpace = true;
@@ -335,12 +716,46 @@ void ADynamicMeshBaseActor::BooleanWithMesh(ADynamicMeshBaseActor* OtherMeshActo
 		if (!bOK)
 		{
 			// fill holes
+			TArray<int32> CrackTriangles;
+			for (int32 eid : Boolean.CreatedBoundaryEdges)
+			{
+				if (ResultMesh.IsEdge(eid))
+				{
+					CrackTriangles.Add(ResultMesh.GetEdgeT(eid).A);
+				}
+			}
+			RTGUtils::FillHolesAroundTriangles(ResultMesh, CrackTriangles);
 		}
 
 		RecomputeNormals(ResultMesh);
 
+		// FMeshBoolean does not report which triangles it created, so use the triangles of the result near OtherMesh,
+		// found the same way as the region of the localized Boolean
+		FAxisAlignedBox3d OtherBounds = (OtherSpatial != nullptr) ? OtherSpatial->GetBoundingBox() : OtherMesh.GetBounds();
+		FAxisAlignedBox3d RegionBounds = FAxisAlignedBox3d::Empty();
+		for (int32 k = 0; k < 8; ++k)
+		{
+			RegionBounds.Contain(OtherToLocal.TransformPosition(OtherBounds.GetCorner(k)));
+		}
+		RegionBounds.Expand(FMathd::Max(LocalRegionExpansion * RegionBounds.MaxDim(), FMathf::ZeroTolerance));
+		for (int32 tid : ResultMesh.TriangleIndicesItr())
+		{
+			if (RegionBounds.Contains(ResultMesh.GetTriCentroid(tid)))
+			{
+				NewTriangles.Add(tid);
+			}
+		}
+
 		MeshToUpdate = MoveTemp(ResultMesh);
 	});
+	SetLastEditTriangles(MoveTemp(NewTriangles));
+}
+
+
+void ADynamicMeshBaseActor::SetLastEditTriangles(TArray<int32>&& Triangles)
+{
+	LastEditTriangles = MoveTemp(Triangles);
+	LastEditTrianglesEditCount = SourceMeshEditCount;
 }
 
 
@@ -394,32 +809,38 @@ void ADynamicMeshBaseActor::CopyFromMesh(ADynamicMeshBaseActor* OtherMesh, bool
 
 void ADynamicMeshBaseActor::SolidifyMesh(int VoxelResolution, float WindingThreshold)
 {
-	if (MeshAABBTree.IsValid() == false)
+	double ExtendBounds = 2.0;
+	FDynamicMesh3 SolidMesh;
+	if (SolidifyMode == EDynamicMeshActorSolidifyMode::SparseGrid || SolidifyMode == EDynamicMeshActorSolidifyMode::BatchedDenseGrid)
 	{
-		MeshAABBTree.Build();
+		// these modes support non-compact meshes, so the trees for SourceMesh can be used directly
+		BuildSourceSpatial();
+		if (SolidifyMode == EDynamicMeshActorSolidifyMode::SparseGrid)
+		{
+			RTGUtils::ComputeSparseSolidify(GetSourceSpatial(), GetSourceFastWinding(), VoxelResolution, WindingThreshold, ExtendBounds, SolidMesh);
+		}
+		else
+		{
+			RTGUtils::ComputeDenseSolidify(GetSourceSpatial(), GetSourceFastWinding(), VoxelResolution, WindingThreshold, ExtendBounds, SolidMesh);
+		}
 	}
-	if (FastWinding->IsBuilt() == false)
+	else
 	{
-		FastWinding->Build();
+		// TImplicitSolidify does not support non-compact meshes
+		const FDynamicMesh3* CompactMesh = nullptr;
+		FDynamicMeshAABBTree3* AABBTree = nullptr;
+		TFastWindingTree<FDynamicMesh3>* Winding = nullptr;
+		GetCompactSpatial(CompactMesh, AABBTree, Winding);
+
+		TImplicitSolidify<FDynamicMesh3> SolidifyCalc(CompactMesh, AABBTree, Winding);
+		SolidifyCalc.SetCellSizeAndExtendBounds(AABBTree->GetBoundingBox(), ExtendBounds, VoxelResolution);
+		SolidifyCalc.WindingThreshold = WindingThreshold;
+		SolidifyCalc.SurfaceSearchSteps = 5;
+		SolidifyCalc.bSolidAtBoundaries = true;
+		SolidifyCalc.ExtendBounds = ExtendBounds;
+		SolidMesh.Copy(&SolidifyCalc.Generate());
 	}
 
-	// ugh workaround for bug
-	FDynamicMesh3 CompactMesh;
-	CompactMesh.CompactCopy(SourceMesh, false, false, false, false);
-	FDynamicMeshAABBTree3 AABBTree(&CompactMesh, true);
-	TFastWindingTree<FDynamicMesh3> Winding(&AABBTree, true);
-
-	double ExtendBounds = 2.0;
-	//TImplicitSolidify<FDynamicMesh3> SolidifyCalc(&SourceMesh, &MeshAABBTree, FastWinding.Get());
-	//SolidifyCalc.SetCellSizeAndExtendBounds(MeshAABBTree.GetBoundingBox(), ExtendBounds, VoxelResolution);
-	TImplicitSolidify<FDynamicMesh3> SolidifyCalc(&CompactMesh, &AABBTree, &Winding);
-	SolidifyCalc.SetCellSizeAndExtendBounds(AABBTree.GetBoundingBox(), ExtendBounds, VoxelResolution);
-	SolidifyCalc.WindingThreshold = WindingThreshold;
-	SolidifyCalc.SurfaceSearchSteps = 5;
-	SolidifyCalc.bSolidAtBoundaries = true;
-	SolidifyCalc.ExtendBounds = ExtendBounds;
-	FDynamicMesh3 SolidMesh(&SolidifyCalc.Generate());
-
 	SolidMesh.EnableAttributes();
 	RecomputeNormals(SolidMesh);
 
@@ -429,17 +850,116 @@ void ADynamicMeshBaseActor::SolidifyMesh(int VoxelResolution, float WindingThres
 	});
 }
 
+
+void ADynamicMeshBaseActor::OffsetMesh(float OffsetDistance, int VoxelResolution)
+{
+	FDynamicMesh3 OffsetResultMesh;
+	if (OffsetMode == EDynamicMeshActorOffsetMode::SparseNarrowBand || OffsetMode == EDynamicMeshActorOffsetMode::BatchedDenseGrid)
+	{
+		// these modes support non-compact meshes, so the trees for SourceMesh can be used directly
+		BuildSourceSpatial();
+		if (OffsetMode == EDynamicMeshActorOffsetMode::SparseNarrowBand)
+		{
+			RTGUtils::ComputeSparseOffset(GetSourceSpatial(), GetSourceFastWinding(), OffsetDistance, VoxelResolution, OffsetResultMesh);
+		}
+		else
+		{
+			RTGUtils::ComputeDenseOffset(GetSourceSpatial(), GetSourceFastWinding(), OffsetDistance, VoxelResolution, OffsetResultMesh);
+		}
+	}
+	else
+	{
+		const FDynamicMesh3* CompactMesh = nullptr;
+		FDynamicMeshAABBTree3* AABBTree = nullptr;
+		TFastWindingTree<FDynamicMesh3>* Winding = nullptr;
+		GetCompactSpatial(CompactMesh, AABBTree, Winding);
+
+		TImplicitMorphology<FDynamicMesh3> ImplicitMorphology;
+		ImplicitMorphology.MorphologyOp = (OffsetDistance >= 0) ?
+			TImplicitMorphology<FDynamicMesh3>::EMorphologyOp::Dilate : TImplicitMorphology<FDynamicMesh3>::EMorphologyOp::Contract;
+		ImplicitMorphology.Source = CompactMesh;
+		ImplicitMorphology.SourceSpatial = AABBTree;
+		ImplicitMorphology.SetCellSizesAndDistance(AABBTree->GetBoundingBox(), FMathd::Abs(OffsetDistance), VoxelResolution, VoxelResolution);
+		OffsetResultMesh.Copy(&ImplicitMorphology.Generate());
+	}
+
+	OffsetResultMesh.EnableAttributes();
+	RecomputeNormals(OffsetResultMesh);
+
+	EditMesh([&](FDynamicMesh3& MeshToUpdate)
+	{
+		MeshToUpdate = MoveTemp(OffsetResultMesh);
+	});
+}
+
+
+void ADynamicMeshBaseActor::GetCompactSpatial(const FDynamicMesh3*& MeshOut, FDynamicMeshAABBTree3*& SpatialOut, TFastWindingTree<FDynamicMesh3>*& WindingOut)
+{
+	const FDynamicMesh3& Mesh = GetMeshRef();
+	if (Mesh.IsCompact())
+	{
+		BuildSourceSpatial();
+		MeshOut = &Mesh;
+		SpatialOut = &GetSourceSpatial();
+		WindingOut = &GetSourceFastWinding();
+		return;
+	}
+
+	// compact copy is kept until the next EditMesh()
+	if (CompactSourceMesh.IsValid() == false)
+	{
+		CompactSourceMesh = MakeUnique<FDynamicMesh3>();
+		CompactSourceMesh->CompactCopy(Mesh, false, false, false, false);
+		CompactMeshAABBTree = MakeUnique<FDynamicMeshAABBTree3>(CompactSourceMesh.Get(), true);
+		CompactFastWinding = MakeUnique<TFastWindingTree<FDynamicMesh3>>(CompactMeshAABBTree.Get(), true);
+	}
+	MeshOut = CompactSourceMesh.Get();
+	SpatialOut = CompactMeshAABBTree.Get();
+	WindingOut = CompactFastWinding.Get();
+}
+
 void ADynamicMeshBaseActor::SimplifyMeshToTriCount(int32 TargetTriangleCount)
 {
 	TargetTriangleCount = FMath::Max(1, TargetTriangleCount);
-	if (TargetTriangleCount >= SourceMesh.TriangleCount()) return;
 
-	// make compacted copy because it seems to change the results?
+	auto SimplifyFunc = [this](FDynamicMesh3& Mesh, int32 TriangleCount)
+	{
+		if (SimplifyMode == EDynamicMeshActorSimplifyMode::ParallelPatches)
+		{
+			if (RTGUtils::ParallelSimplifyToTriangleCount(Mesh, TriangleCount) == false)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Parallel simplification could not weld all patch borders, the mesh has cracks"));
+			}
+		}
+		else
+		{
+			FQEMSimplification Simplifier(&Mesh);
+			Simplifier.SimplifyToTriangleCount(TriangleCount);
+		}
+	};
+
 	FDynamicMesh3 SimplifyMesh;
-	SimplifyMesh.CompactCopy(SourceMesh, false, false, false, false);
-	SimplifyMesh.EnableTriangleGroups();			// workaround for failing check()
-	FQEMSimplification Simplifier(&SimplifyMesh);
-	Simplifier.SimplifyToTriangleCount(TargetTriangleCount);
+	if (bCacheSimplificationLODs)
+	{
+		if (!SimplifyLODChain.IsValid() || SimplifyLODChainEditCount != SourceMeshEditCount)
+		{
+			FDynamicMesh3 BaseMesh;
+			BaseMesh.CompactCopy(GetMeshRef(), false, false, false, false);
+			BaseMesh.EnableTriangleGroups();			// workaround for failing check()
+			SimplifyLODChain = MakeUnique<RTGUtils::FSimplificationLODChain>();
+			SimplifyLODChain->Build(BaseMesh, SimplifyFunc);
+		}
+		SimplifyLODChain->GetMesh(TargetTriangleCount, SimplifyFunc, SimplifyMesh);
+	}
+	else
+	{
+		if (TargetTriangleCount >= GetMeshRef().TriangleCount()) return;
+
+		// make compacted copy because it seems to change the results?
+		SimplifyMesh.CompactCopy(GetMeshRef(), false, false, false, false);
+		SimplifyMesh.EnableTriangleGroups();			// workaround for failing check()
+		SimplifyFunc(SimplifyMesh, TargetTriangleCount);
+	}
 	SimplifyMesh.EnableAttributes();
 	RecomputeNormals(SimplifyMesh);
 
@@ -447,4 +967,68 @@ void ADynamicMeshBaseActor::SimplifyMeshToTriCount(int32 TargetTriangleCount)
 	{
 		MeshToUpdate.CompactCopy(SimplifyMesh);
 	});
+
+	// SourceMesh is now one of the LODs, so the chain is still valid
+	if (bCacheSimplificationLODs)
+	{
+		SimplifyLODChainEditCount = SourceMeshEditCount;
+	}
+}
+
+
+void ADynamicMeshBaseActor::RemeshMesh(float TargetEdgeLength, float SmoothingSpeed)
+{
+	if (TargetEdgeLength <= 0) return;
+
+	FDynamicMesh3 RemeshedMesh;
+	RemeshedMesh.CompactCopy(GetMeshRef(), false, false, false, false);
+	if (RemeshMode == EDynamicMeshActorRemeshMode::ParallelPatches)
+	{
+		if (RTGUtils::ParallelRemesh(RemeshedMesh, TargetEdgeLength, SmoothingSpeed) == false)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Parallel remeshing could not weld all patch borders, the mesh has cracks"));
+		}
+	}
+	else
+	{
+		FQueueRemesher Remesher(&RemeshedMesh);
+		Remesher.SetTargetEdgeLength(TargetEdgeLength);
+		Remesher.SmoothSpeedT = SmoothingSpeed;
+		Remesher.FastestRemesh();
+	}
+	RemeshedMesh.EnableAttributes();
+	RecomputeNormals(RemeshedMesh);
+
+	EditMesh([&](FDynamicMesh3& MeshToUpdate)
+	{
+		MeshToUpdate.CompactCopy(RemeshedMesh);
+	});
+}
+
+
+void ADynamicMeshBaseActor::RemeshEditedRegion(float TargetEdgeLength, int ExpandRings, float SmoothingSpeed)
+{
+	if (TargetEdgeLength <= 0 || LastEditTrianglesEditCount != SourceMeshEditCount || LastEditTriangles.Num() == 0) return;
+
+	TArray<int32> RegionTriangles;
+	EditMesh([&](FDynamicMesh3& MeshToUpdate)
+	{
+		if (RTGUtils::RemeshRegion(MeshToUpdate, LastEditTriangles, TargetEdgeLength, ExpandRings, SmoothingSpeed, &RegionTriangles) == false)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Remeshed region could not be welded back into the mesh, the mesh has cracks"));
+		}
+		RecomputeNormals(MeshToUpdate);
+	});
+
+	// the remeshed region is the new edited region, so repeated calls refine it further
+	SetLastEditTriangles(MoveTemp(RegionTriangles));
+}
+
+
+void ADynamicMeshBaseActor::GenerateChartUVs(float MaxChartNormalAngle)
+{
+	EditMesh([&](FDynamicMesh3& MeshToUpdate)
+	{
+		RTGUtils::ComputeChartUVs(MeshToUpdate, MaxChartNormalAngle);
+	});
 }
@@ -29,6 +29,20 @@ void ADynamicPMCActor::OnMeshEditedInternal()
 	Super::OnMeshEditedInternal();
 }
 
+void ADynamicPMCActor::OnMeshPositionsEditedInternal(bool bNormalsModified)
+{
+	// vertex-only update of the existing section, collision is also updated by the PMC if the section has it
+	bool bUseFaceNormals = (this->NormalsMode == EDynamicMeshActorNormalsMode::FaceNormals);
+	if (MeshComponent && RTGUtils::UpdatePMCPositionsFromDynamicMesh_SplitTriangles(MeshComponent, &SourceMesh, bNormalsModified, bUseFaceNormals))
+	{
+		OnMeshModified.Broadcast(this);
+	}
+	else
+	{
+		Super::OnMeshPositionsEditedInternal(bNormalsModified);
+	}
+}
+
 void ADynamicPMCActor::UpdatePMCMesh()
 {
 	if (MeshComponent)
@@ -46,7 +60,7 @@ void ADynamicPMCActor::UpdatePMCMesh()
 			MeshComponent->bUseComplexAsSimpleCollision = true;
 		}
 
-		RTGUtils::UpdatePMCFromDynamicMesh_SplitTriangles(MeshComponent, &SourceMesh, bUseFaceNormals, bUseUV0, bUseVertexColors, bGenerateSectionCollision);
+		RTGUtils::UpdatePMCFromDynamicMesh_SplitTriangles(MeshComponent, &GetMeshRef(), bUseFaceNormals, bUseUV0, bUseVertexColors, bGenerateSectionCollision);
 
 		// update material on new section
 		UMaterialInterface* UseMaterial = (this->Material != nullptr) ? this->Material : UMaterial::GetDefaultMaterial(MD_Surface);
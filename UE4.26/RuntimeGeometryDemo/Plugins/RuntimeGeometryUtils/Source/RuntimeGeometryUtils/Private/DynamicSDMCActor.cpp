@@ -1,5 +1,6 @@
 #include "DynamicSDMCActor.h"
 #include "DynamicMesh3.h"
+#include "DynamicMeshAttributeSet.h"
 
 
 // Sets default values
@@ -30,11 +31,42 @@ void ADynamicSDMCActor::OnMeshEditedInternal()
 	Super::OnMeshEditedInternal();
 }
 
+void ADynamicSDMCActor::OnMeshPositionsEditedInternal(bool bNormalsModified)
+{
+	FDynamicMesh3* ComponentMesh = (MeshComponent) ? MeshComponent->GetMesh() : nullptr;
+	if (ComponentMesh == nullptr || ComponentMesh->MaxVertexID() != SourceMesh.MaxVertexID() || ComponentMesh->TriangleCount() != SourceMesh.TriangleCount()
+		|| ComponentMesh->HasAttributes() != SourceMesh.HasAttributes()
+		|| (SourceMesh.HasAttributes() && ComponentMesh->Attributes()->PrimaryNormals()->MaxElementID() != SourceMesh.Attributes()->PrimaryNormals()->MaxElementID()))
+	{
+		// topology of the Component mesh does not match, do a full update
+		Super::OnMeshPositionsEditedInternal(bNormalsModified);
+		return;
+	}
+
+	for (int32 vid : SourceMesh.VertexIndicesItr())
+	{
+		ComponentMesh->SetVertex(vid, SourceMesh.GetVertex(vid));
+	}
+	if (bNormalsModified && SourceMesh.HasAttributes())
+	{
+		const FDynamicMeshNormalOverlay* SourceNormals = SourceMesh.Attributes()->PrimaryNormals();
+		FDynamicMeshNormalOverlay* ComponentNormals = ComponentMesh->Attributes()->PrimaryNormals();
+		for (int32 ElemID : SourceNormals->ElementIndicesItr())
+		{
+			ComponentNormals->SetElement(ElemID, SourceNormals->GetElement(ElemID));
+		}
+	}
+
+	// only updates the vertex buffers of the existing render proxy
+	MeshComponent->FastNotifyPositionsUpdated(bNormalsModified);
+	OnMeshModified.Broadcast(this);
+}
+
 void ADynamicSDMCActor::UpdateSDMCMesh()
 {
 	if (MeshComponent)
 	{
-		*(MeshComponent->GetMesh()) = SourceMesh;
+		*(MeshComponent->GetMesh()) = GetMeshRef();
 		MeshComponent->NotifyMeshUpdated();
 
 		// update material on new section
@@ -53,7 +53,7 @@ void ADynamicSMCActor::UpdateSMCMesh()
 
 	if (MeshComponent)
 	{
-		RTGUtils::UpdateStaticMeshFromDynamicMesh(StaticMesh, &SourceMesh);
+		RTGUtils::UpdateStaticMeshFromDynamicMesh(StaticMesh, &GetMeshRef());
 
 		// update material on new section
 		UMaterialInterface* UseMaterial = (this->Material != nullptr) ? this->Material : UMaterial::GetDefaultMaterial(MD_Surface);
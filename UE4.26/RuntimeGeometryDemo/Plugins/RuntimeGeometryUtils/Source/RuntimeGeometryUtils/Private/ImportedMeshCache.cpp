@@ -0,0 +1,62 @@
+#include "ImportedMeshCache.h"
+
+#include "Misc/ScopeLock.h"
+
+
+namespace
+{
+	FCriticalSection ImportedMeshesLock;
+	TMap<RTGUtils::FImportedMeshKey, TWeakPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe>> ImportedMeshes;
+}
+
+
+RTGUtils::FSharedImportedMesh::FSharedImportedMesh()
+	: AABBTree(&Mesh, false), FastWinding(&AABBTree, false)
+{
+}
+
+
+void RTGUtils::FSharedImportedMesh::BuildSpatial(bool bBuildFastWinding)
+{
+	FScopeLock Lock(&BuildLock);
+	if (AABBTree.IsValid() == false)
+	{
+		AABBTree.Build();
+	}
+	if (bBuildFastWinding && FastWinding.IsBuilt() == false)
+	{
+		FastWinding.Build();
+	}
+}
+
+
+TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> RTGUtils::FindOrAddImportedMesh(
+	const FImportedMeshKey& Key,
+	TFunctionRef<void(FDynamicMesh3&)> ImportFunc)
+{
+	FScopeLock Lock(&ImportedMeshesLock);
+
+	TWeakPtr<FSharedImportedMesh, ESPMode::ThreadSafe>* Found = ImportedMeshes.Find(Key);
+	if (Found != nullptr)
+	{
+		TSharedPtr<FSharedImportedMesh, ESPMode::ThreadSafe> Existing = Found->Pin();
+		if (Existing.IsValid())
+		{
+			return Existing;
+		}
+	}
+
+	// discard the entries of meshes that have been released
+	for (auto It = ImportedMeshes.CreateIterator(); It; ++It)
+	{
+		if (It->Value.IsValid() == false)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TSharedPtr<FSharedImportedMesh, ESPMode::ThreadSafe> NewMesh = MakeShared<FSharedImportedMesh, ESPMode::ThreadSafe>();
+	ImportFunc(NewMesh->Mesh);
+	ImportedMeshes.Add(Key, NewMesh);
+	return NewMesh;
+}
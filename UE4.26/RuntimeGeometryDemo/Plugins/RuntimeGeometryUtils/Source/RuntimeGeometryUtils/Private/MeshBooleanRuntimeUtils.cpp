@@ -0,0 +1,890 @@
+#include "MeshBooleanRuntimeUtils.h"
+
+#include "DynamicSubmesh3.h"
+#include "DynamicMeshEditor.h"
+#include "MeshTransforms.h"
+#include "MeshNormalsRuntimeUtils.h"
+#include "MeshBoundaryLoops.h"
+#include "Operations/MinimalHoleFiller.h"
+#include "MeshFieldRuntimeUtils.h"
+#include "Spatial/PointHashGrid3.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+
+
+void RTGUtils::FindTrianglesInBox(
+	const FDynamicMesh3& Mesh,
+	FDynamicMeshAABBTree3& Spatial,
+	const FAxisAlignedBox3d& QueryBox,
+	TArray<int32>& TrianglesOut)
+{
+	FDynamicMeshAABBTree3::FTreeTraversal Traversal;
+	Traversal.NextBoxF = [&QueryBox](const FAxisAlignedBox3d& Box, int Depth)
+	{
+		return Box.Intersects(QueryBox);
+	};
+	Traversal.NextTriangleF = [&](int TriangleID)
+	{
+		FVector3d A, B, C;
+		Mesh.GetTriVertices(TriangleID, A, B, C);
+		FAxisAlignedBox3d TriBounds = FAxisAlignedBox3d::Empty();
+		TriBounds.Contain(A);
+		TriBounds.Contain(B);
+		TriBounds.Contain(C);
+		if (TriBounds.Intersects(QueryBox))
+		{
+			TrianglesOut.Add(TriangleID);
+		}
+	};
+	Spatial.DoTraversal(Traversal);
+}
+
+
+
+/**
+ * Append ToolMesh to TargetMesh, transformed by ToolTransform, and optionally with reversed orientation.
+ */
+static void AppendTransformedMesh(FDynamicMesh3& TargetMesh, const FDynamicMesh3& ToolMesh, const FTransform3d& ToolTransform, bool bReverseOrientation, TArray<int32>* NewTrianglesOut)
+{
+	FDynamicMeshEditor Editor(&TargetMesh);
+	FMeshIndexMappings Mappings;
+	double NormalSign = (bReverseOrientation) ? -1.0 : 1.0;
+	Editor.AppendMesh(&ToolMesh, Mappings,
+		[&ToolTransform](int32 vid, const FVector3d& Position) { return ToolTransform.TransformPosition(Position); },
+		[&ToolTransform, NormalSign](int32 vid, const FVector3d& Normal) { return NormalSign * ToolTransform.TransformNormal(Normal); });
+	for (int32 tid : ToolMesh.TriangleIndicesItr())
+	{
+		int32 NewTriID = Mappings.GetNewTriangle(tid);
+		if (bReverseOrientation)
+		{
+			TargetMesh.ReverseTriOrientation(NewTriID);
+		}
+		if (NewTrianglesOut != nullptr)
+		{
+			NewTrianglesOut->Add(NewTriID);
+		}
+	}
+}
+
+
+/**
+ * Apply a Union or Difference with a ToolMesh that does not touch any triangle of TargetMesh. The tool is either entirely outside
+ * TargetMesh, in which case Union appends it and Difference does nothing, or entirely inside TargetMesh, in which case Union
+ * does nothing and Difference appends it with reversed orientation as a cavity. One tool vertex is enough to tell the two cases apart.
+ */
+static void ApplyDisjointToolBoolean(
+	FDynamicMesh3& TargetMesh,
+	TFastWindingTree<FDynamicMesh3>& TargetWinding,
+	const FDynamicMesh3& ToolMesh,
+	const FTransform3d& ToolTransform,
+	FMeshBoolean::EBooleanOp Operation,
+	TArray<int32>* NewTrianglesOut)
+{
+	if (ToolMesh.TriangleCount() == 0)
+	{
+		return;
+	}
+	int32 ToolVertexID = *ToolMesh.VertexIndicesItr().begin();
+	bool bToolInside = TargetWinding.IsInside(ToolTransform.TransformPosition(ToolMesh.GetVertex(ToolVertexID)), 0.5);
+	if (Operation == FMeshBoolean::EBooleanOp::Union && bToolInside == false)
+	{
+		AppendTransformedMesh(TargetMesh, ToolMesh, ToolTransform, false, NewTrianglesOut);
+	}
+	else if (Operation == FMeshBoolean::EBooleanOp::Difference && bToolInside)
+	{
+		AppendTransformedMesh(TargetMesh, ToolMesh, ToolTransform, true, NewTrianglesOut);
+	}
+}
+
+
+
+/**
+ * Merge the pairs of coincident boundary edges in Edges, ie the edges whose endpoints are within VertexTolerance of each other.
+ * Only Edges are hashed and searched, so unlike FMergeCoincidentMeshEdges the cost does not depend on the size of Mesh, and
+ * coincident boundary edges elsewhere in Mesh are not welded. Invalid and non-boundary edges in Edges are ignored.
+ * @return false if any pair of coincident edges could not be merged
+ */
+static bool WeldBoundaryEdges(FDynamicMesh3& Mesh, const TArray<int32>& Edges, double VertexTolerance)
+{
+	auto EdgeMidpoint = [&Mesh](int32 eid)
+	{
+		FIndex2i EdgeV = Mesh.GetEdgeV(eid);
+		return 0.5 * (Mesh.GetVertex(EdgeV.A) + Mesh.GetVertex(EdgeV.B));
+	};
+
+	double SearchRadius = FMathd::Max(2.0 * VertexTolerance, FMathf::ZeroTolerance);
+	TPointHashGrid3d<int32> EdgeHash(SearchRadius, -1);
+	TArray<int32> BoundaryEdges;
+	for (int32 eid : Edges)
+	{
+		if (Mesh.IsEdge(eid) && Mesh.IsBoundaryEdge(eid))
+		{
+			BoundaryEdges.Add(eid);
+			EdgeHash.InsertPointUnsafe(eid, EdgeMidpoint(eid));
+		}
+	}
+
+	double VertexToleranceSqr = VertexTolerance * VertexTolerance;
+	auto IsCoincident = [&Mesh, VertexToleranceSqr](int32 EdgeA, int32 EdgeB)
+	{
+		FIndex2i EdgeVA = Mesh.GetEdgeV(EdgeA), EdgeVB = Mesh.GetEdgeV(EdgeB);
+		FVector3d A0 = Mesh.GetVertex(EdgeVA.A), A1 = Mesh.GetVertex(EdgeVA.B);
+		FVector3d B0 = Mesh.GetVertex(EdgeVB.A), B1 = Mesh.GetVertex(EdgeVB.B);
+		return (A0.DistanceSquared(B0) <= VertexToleranceSqr && A1.DistanceSquared(B1) <= VertexToleranceSqr)
+			|| (A0.DistanceSquared(B1) <= VertexToleranceSqr && A1.DistanceSquared(B0) <= VertexToleranceSqr);
+	};
+
+	// merging an edge can also merge an adjacent pair, and discards the other edge, so re-check both edges before each merge
+	bool bAllMerged = true;
+	for (int32 eid : BoundaryEdges)
+	{
+		if (Mesh.IsEdge(eid) == false || Mesh.IsBoundaryEdge(eid) == false)
+		{
+			continue;
+		}
+		FVector3d Midpoint = EdgeMidpoint(eid);
+		TPair<int32, double> Nearest = EdgeHash.FindNearestInRadius(Midpoint, SearchRadius,
+			[&](const int32& OtherEdge) { return Midpoint.DistanceSquared(EdgeMidpoint(OtherEdge)); },
+			[&](const int32& OtherEdge) { return OtherEdge == eid || Mesh.IsEdge(OtherEdge) == false || Mesh.IsBoundaryEdge(OtherEdge) == false; });
+		if (Nearest.Key >= 0 && IsCoincident(eid, Nearest.Key))
+		{
+			FDynamicMesh3::FMergeEdgesInfo MergeInfo;
+			if (Mesh.MergeEdges(eid, Nearest.Key, MergeInfo) != EMeshResult::Ok)
+			{
+				bAllMerged = false;
+			}
+		}
+	}
+	return bAllMerged;
+}
+
+
+
+bool RTGUtils::ComputeLocalizedBoolean(
+	FDynamicMesh3& TargetMesh,
+	FDynamicMeshAABBTree3& TargetSpatial,
+	TFastWindingTree<FDynamicMesh3>& TargetWinding,
+	const FDynamicMesh3& ToolMesh,
+	const FTransform3d& ToolTransform,
+	FMeshBoolean::EBooleanOp Operation,
+	double RegionExpansion,
+	FDynamicMeshAABBTree3* ToolSpatial,
+	TArray<int32>* NewTrianglesOut)
+{
+	if (!ensure(Operation == FMeshBoolean::EBooleanOp::Union || Operation == FMeshBoolean::EBooleanOp::Difference))
+	{
+		return false;
+	}
+
+	// find the triangles of TargetMesh near ToolMesh. Any triangle that the ToolMesh could cut
+	// touches the tool bounds, so the border of this region is never modified by the Boolean
+	FAxisAlignedBox3d ToolBounds = (ToolSpatial != nullptr) ? ToolSpatial->GetBoundingBox() : ToolMesh.GetBounds();
+	FAxisAlignedBox3d LocalToolBounds = FAxisAlignedBox3d::Empty();
+	for (int32 k = 0; k < 8; ++k)
+	{
+		LocalToolBounds.Contain(ToolTransform.TransformPosition(ToolBounds.GetCorner(k)));
+	}
+	FAxisAlignedBox3d RegionBounds = LocalToolBounds;
+	RegionBounds.Expand(FMathd::Max(RegionExpansion * RegionBounds.MaxDim(), FMathf::ZeroTolerance));
+	TArray<int32> RegionTriangles;
+	FindTrianglesInBox(TargetMesh, TargetSpatial, RegionBounds, RegionTriangles);
+	if (RegionTriangles.Num() == 0)
+	{
+		ApplyDisjointToolBoolean(TargetMesh, TargetWinding, ToolMesh, ToolTransform, Operation, NewTrianglesOut);
+		return true;
+	}
+
+	FDynamicSubmesh3 Region(&TargetMesh, RegionTriangles);
+	const FDynamicMesh3& RegionMesh = Region.GetSubmesh();
+
+	// cut the region by the tool, and discard the part of the region inside the tool (for both Union and Difference)
+	FDynamicMesh3 RegionResult;
+	FMeshBoolean RegionTrim(
+		&RegionMesh, FTransform3d::Identity(),
+		&ToolMesh, ToolTransform,
+		&RegionResult, FMeshBoolean::EBooleanOp::TrimInside);
+	RegionTrim.bPutResultInInputSpace = true;
+	bool bRegionOK = RegionTrim.Compute();
+
+	// cut the tool by the region, but keep all of it (the result is in the local space of TargetMesh). The region is not closed, so its winding number
+	// cannot be used to decide which tool triangles to keep, we use the winding number of the full TargetMesh below
+	FDynamicMesh3 ToolResult;
+	FMeshBoolean ToolCut(
+		&ToolMesh, ToolTransform,
+		&RegionMesh, FTransform3d::Identity(),
+		&ToolResult, FMeshBoolean::EBooleanOp::TrimInside);
+	ToolCut.bPutResultInInputSpace = true;
+	ToolCut.WindingThreshold = TNumericLimits<double>::Max();
+	bool bToolOK = ToolCut.Compute();
+
+	// Union keeps the tool outside of TargetMesh, Difference keeps the tool inside TargetMesh (with flipped orientation)
+	bool bKeepInside = (Operation == FMeshBoolean::EBooleanOp::Difference);
+	TArray<uint8> KeepTri;
+	KeepTri.SetNumZeroed(ToolResult.MaxTriangleID());
+	ParallelFor(ToolResult.MaxTriangleID(), [&](int32 tid)
+	{
+		if (ToolResult.IsTriangle(tid))
+		{
+			bool bInside = TargetWinding.IsInside(ToolResult.GetTriCentroid(tid), 0.5);
+			KeepTri[tid] = (bInside == bKeepInside) ? 1 : 0;
+		}
+	});
+	TArray<int32> RemoveTriangles;
+	for (int32 tid : ToolResult.TriangleIndicesItr())
+	{
+		if (KeepTri[tid] == 0)
+		{
+			RemoveTriangles.Add(tid);
+		}
+	}
+	FDynamicMeshEditor ToolEditor(&ToolResult);
+	ToolEditor.RemoveTriangles(RemoveTriangles, true);
+	if (bKeepInside)
+	{
+		ToolResult.ReverseOrientation(true);
+	}
+
+	// the edges of the region triangles that remain after removing them are the border of the hole
+	TSet<int32> RegionEdges;
+	for (int32 tid : RegionTriangles)
+	{
+		FIndex3i TriEdges = TargetMesh.GetTriEdges(tid);
+		RegionEdges.Add(TriEdges.A);
+		RegionEdges.Add(TriEdges.B);
+		RegionEdges.Add(TriEdges.C);
+	}
+
+	// replace the region in TargetMesh with the cut region and the kept part of the tool
+	FDynamicMeshEditor Editor(&TargetMesh);
+	Editor.RemoveTriangles(RegionTriangles, true);
+	TArray<int32> WeldEdges;
+	for (int32 eid : RegionEdges)
+	{
+		if (TargetMesh.IsEdge(eid) && TargetMesh.IsBoundaryEdge(eid))
+		{
+			WeldEdges.Add(eid);
+		}
+	}
+	FMeshIndexMappings RegionMappings, ToolMappings;
+	Editor.AppendMesh(&RegionResult, RegionMappings);
+	Editor.AppendMesh(&ToolResult, ToolMappings);
+	for (int32 eid : RegionResult.BoundaryEdgeIndicesItr())
+	{
+		FIndex2i EdgeV = RegionResult.GetEdgeV(eid);
+		WeldEdges.Add(TargetMesh.FindEdge(RegionMappings.GetNewVertex(EdgeV.A), RegionMappings.GetNewVertex(EdgeV.B)));
+	}
+	for (int32 eid : ToolResult.BoundaryEdgeIndicesItr())
+	{
+		FIndex2i EdgeV = ToolResult.GetEdgeV(eid);
+		WeldEdges.Add(TargetMesh.FindEdge(ToolMappings.GetNewVertex(EdgeV.A), ToolMappings.GetNewVertex(EdgeV.B)));
+	}
+	if (NewTrianglesOut != nullptr)
+	{
+		for (int32 tid : RegionResult.TriangleIndicesItr())
+		{
+			NewTrianglesOut->Add(RegionMappings.GetNewTriangle(tid));
+		}
+		for (int32 tid : ToolResult.TriangleIndicesItr())
+		{
+			NewTrianglesOut->Add(ToolMappings.GetNewTriangle(tid));
+		}
+	}
+
+	// weld the region border and the cut curve. The region border vertices are exact copies, the cut
+	// curves of the two Booleans only match up to the snapping tolerance used by the mesh cutting.
+	// FMeshBoolean scales its inputs by the inverse of their combined bounds size, so SnapTolerance is relative to that size.
+	FAxisAlignedBox3d CombinedBounds = RegionMesh.GetBounds();
+	CombinedBounds.Contain(LocalToolBounds);
+	double InputScale = FMathd::Clamp(CombinedBounds.MaxDim(), 0.01, 1000000.0);
+	bool bWeldOK = WeldBoundaryEdges(TargetMesh, WeldEdges, 2.0 * RegionTrim.SnapTolerance * InputScale);
+
+	return bRegionOK && bToolOK && bWeldOK;
+}
+
+
+
+
+/**
+ * Combine the narrow-band signed distance grids of the target and tool meshes, which must have the same layout, into CombinedOut.
+ * Union takes the minimum of the two distances and Difference takes max(Target, -Tool). Blocks that are unallocated in both
+ * grids stay unallocated, so CombinedOut only stores the blocks near either surface.
+ */
+static void CombineFieldGrids(const RTGUtils::FSparseFieldGrid& TargetGrid, const RTGUtils::FSparseFieldGrid& ToolGrid, bool bUnion, RTGUtils::FSparseFieldGrid& CombinedOut)
+{
+	auto Combine = [bUnion](float TargetValue, float ToolValue) { return (bUnion) ? FMath::Min(TargetValue, ToolValue) : FMath::Max(TargetValue, -ToolValue); };
+
+	CombinedOut = TargetGrid;
+	CombinedOut.BlockValues.Reset();
+	TArray<int32> AllocatedBlocks;
+	for (int32 BlockID = 0; BlockID < TargetGrid.TotalBlocks(); ++BlockID)
+	{
+		CombinedOut.BlockDataIndex[BlockID] = -1;
+		if (TargetGrid.BlockDataIndex[BlockID] >= 0 || ToolGrid.BlockDataIndex[BlockID] >= 0)
+		{
+			CombinedOut.BlockDataIndex[BlockID] = AllocatedBlocks.Add(BlockID);
+		}
+		else
+		{
+			CombinedOut.BlockUniformValue[BlockID] = Combine(TargetGrid.BlockUniformValue[BlockID], ToolGrid.BlockUniformValue[BlockID]);
+		}
+	}
+
+	const int32 BlockSize = TargetGrid.BlockSize;
+	CombinedOut.BlockValues.SetNum(AllocatedBlocks.Num());
+	ParallelFor(AllocatedBlocks.Num(), [&](int32 k)
+	{
+		FVector3i FirstIndex = TargetGrid.GetBlockCoords(AllocatedBlocks[k]) * BlockSize;
+		TArray<float>& Values = CombinedOut.BlockValues[k];
+		Values.SetNumUninitialized(BlockSize * BlockSize * BlockSize);
+		for (int32 z = 0; z < BlockSize; ++z)
+		{
+			for (int32 y = 0; y < BlockSize; ++y)
+			{
+				for (int32 x = 0; x < BlockSize; ++x)
+				{
+					FVector3i Index = FirstIndex + FVector3i(x, y, z);
+					Values[x + BlockSize * (y + BlockSize * z)] = Combine(TargetGrid.GetValue(Index), ToolGrid.GetValue(Index));
+				}
+			}
+		}
+	});
+}
+
+
+/**
+ * Find the boundary loops formed by BoundaryEdges, as lists of vertices ordered along the triangle orientation of the boundary edges.
+ * Bowtie vertices are resolved arbitrarily, and open chains (which only occur if BoundaryEdges is not a union of loops) are discarded.
+ */
+static void FindBoundaryLoops(const FDynamicMesh3& Mesh, const TArray<int32>& BoundaryEdges, TArray<TArray<int32>>& LoopsOut)
+{
+	TMultiMap<int32, int32> OutgoingEdges;
+	for (int32 eid : BoundaryEdges)
+	{
+		OutgoingEdges.Add(Mesh.GetOrientedBoundaryEdgeV(eid).A, eid);
+	}
+
+	TSet<int32> UsedEdges;
+	for (int32 StartEdge : BoundaryEdges)
+	{
+		if (UsedEdges.Contains(StartEdge))
+		{
+			continue;
+		}
+
+		TArray<int32> Loop;
+		int32 StartVertex = Mesh.GetOrientedBoundaryEdgeV(StartEdge).A;
+		int32 CurEdge = StartEdge;
+		bool bClosed = false;
+		while (CurEdge >= 0)
+		{
+			UsedEdges.Add(CurEdge);
+			FIndex2i EdgeV = Mesh.GetOrientedBoundaryEdgeV(CurEdge);
+			Loop.Add(EdgeV.A);
+			if (EdgeV.B == StartVertex)
+			{
+				bClosed = true;
+				break;
+			}
+			CurEdge = -1;
+			for (auto It = OutgoingEdges.CreateConstKeyIterator(EdgeV.B); It; ++It)
+			{
+				if (UsedEdges.Contains(It.Value()) == false)
+				{
+					CurEdge = It.Value();
+					break;
+				}
+			}
+		}
+
+		if (bClosed && Loop.Num() >= 3)
+		{
+			LoopsOut.Add(MoveTemp(Loop));
+		}
+	}
+}
+
+
+/**
+ * Connect two boundary loops of Mesh with a strip of triangles. HoleLoop and PatchLoop must be ordered along their boundary edge orientation,
+ * so for two loops bounding an annulus they run in opposite directions. HoleLoop is walked forwards and PatchLoop backwards, and at each step
+ * the triangle that creates the shorter diagonal is added. Triangles that would create non-manifold edges are skipped.
+ */
+static void ZipperLoops(FDynamicMesh3& Mesh, const TArray<int32>& HoleLoop, const TArray<int32>& PatchLoop, TArray<int32>& NewTrianglesOut)
+{
+	int32 NumH = HoleLoop.Num(), NumP = PatchLoop.Num();
+
+	// start the patch loop at the vertex nearest to the start of the hole loop
+	FVector3d HoleStart = Mesh.GetVertex(HoleLoop[0]);
+	int32 PatchStart = 0;
+	double MinDistSqr = TNumericLimits<double>::Max();
+	for (int32 k = 0; k < NumP; ++k)
+	{
+		double DistSqr = HoleStart.DistanceSquared(Mesh.GetVertex(PatchLoop[k]));
+		if (DistSqr < MinDistSqr)
+		{
+			MinDistSqr = DistSqr;
+			PatchStart = k;
+		}
+	}
+
+	auto H = [&](int32 Step) { return HoleLoop[Step % NumH]; };
+	auto P = [&](int32 Step) { return PatchLoop[((PatchStart - Step) % NumP + NumP) % NumP]; };
+
+	int32 StepH = 0, StepP = 0;
+	while (StepH < NumH || StepP < NumP)
+	{
+		bool bAdvanceHole = (StepP == NumP);
+		if (StepH < NumH && StepP < NumP)
+		{
+			double HoleDiagonal = Mesh.GetVertex(H(StepH + 1)).DistanceSquared(Mesh.GetVertex(P(StepP)));
+			double PatchDiagonal = Mesh.GetVertex(P(StepP + 1)).DistanceSquared(Mesh.GetVertex(H(StepH)));
+			bAdvanceHole = (HoleDiagonal <= PatchDiagonal);
+		}
+
+		int32 NewTriID = bAdvanceHole ?
+			Mesh.AppendTriangle(H(StepH + 1), H(StepH), P(StepP)) :
+			Mesh.AppendTriangle(P(StepP), P(StepP + 1), H(StepH));
+		if (NewTriID >= 0)
+		{
+			NewTrianglesOut.Add(NewTriID);
+		}
+		if (bAdvanceHole)
+		{
+			StepH++;
+		}
+		else
+		{
+			StepP++;
+		}
+	}
+}
+
+
+/**
+ * Set a per-triangle normal on any of Triangles that does not have normals set in the primary normals overlay of Mesh
+ */
+static void SetMissingFaceNormals(FDynamicMesh3& Mesh, const TArray<int32>& Triangles)
+{
+	if (Mesh.HasAttributes() == false)
+	{
+		return;
+	}
+	FDynamicMeshNormalOverlay* Normals = Mesh.Attributes()->PrimaryNormals();
+	for (int32 tid : Triangles)
+	{
+		if (Mesh.IsTriangle(tid) && Normals->IsSetTriangle(tid) == false)
+		{
+			int32 ElemID = Normals->AppendElement(FVector3f(Mesh.GetTriNormal(tid)));
+			Normals->SetTriangle(tid, FIndex3i(ElemID, ElemID, ElemID));
+		}
+	}
+}
+
+
+
+bool RTGUtils::ComputeLocalizedVoxelBooleanPatch(
+	const FDynamicMesh3& TargetMesh,
+	FDynamicMeshAABBTree3& TargetSpatial,
+	TFastWindingTree<FDynamicMesh3>& TargetWinding,
+	const FDynamicMesh3& ToolMesh,
+	const FTransform3d& ToolTransform,
+	FMeshBoolean::EBooleanOp Operation,
+	FLocalizedVoxelBooleanPatch& PatchOut,
+	int32 VoxelResolution,
+	double TimeBudgetSeconds,
+	double RegionExpansion)
+{
+	if (!ensure(Operation == FMeshBoolean::EBooleanOp::Union || Operation == FMeshBoolean::EBooleanOp::Difference))
+	{
+		return false;
+	}
+	double StartTime = FPlatformTime::Seconds();
+
+	// the tool is generally small, so it is cheaper to copy it into the local space of TargetMesh than to transform each sample point.
+	// This also means the distances are correct if ToolTransform has a non-uniform scale.
+	FDynamicMesh3 LocalTool;
+	LocalTool.Copy(ToolMesh, false, false, false, false);
+	MeshTransforms::ApplyTransform(LocalTool, ToolTransform);
+	FDynamicMeshAABBTree3 ToolSpatial(&LocalTool);
+	TFastWindingTree<FDynamicMesh3> ToolWinding(&ToolSpatial);
+
+	VoxelResolution = FMath::Clamp(VoxelResolution, 4, 512);
+	FAxisAlignedBox3d ToolBounds = ToolSpatial.GetBoundingBox();
+	double CellSize = FMathd::Max(ToolBounds.MaxDim() / (double)VoxelResolution, FMathf::ZeroTolerance);
+
+	// the region must be at least a few cells larger than the tool, so that the extracted surface near the region border only comes from TargetMesh
+	FAxisAlignedBox3d RegionBounds = ToolBounds;
+	RegionBounds.Expand(FMathd::Max(RegionExpansion * ToolBounds.MaxDim(), 2.0 * CellSize));
+	PatchOut = FLocalizedVoxelBooleanPatch();
+	TArray<int32>& RegionTriangles = PatchOut.RegionTriangles;
+	FindTrianglesInBox(TargetMesh, TargetSpatial, RegionBounds, RegionTriangles);
+	if (RegionTriangles.Num() == 0)
+	{
+		// the patch is either empty or the (transformed) tool, which is appended to TargetMesh without stitching
+		if (TargetMesh.HasAttributes() && ToolMesh.HasAttributes())
+		{
+			PatchOut.PatchMesh.EnableAttributes();
+		}
+		ApplyDisjointToolBoolean(PatchOut.PatchMesh, TargetWinding, ToolMesh, ToolTransform, Operation, nullptr);
+		return true;
+	}
+
+	// the grid has to cover the region triangles, which can extend past RegionBounds, plus one layer of cells
+	FAxisAlignedBox3d GridBounds = RegionBounds;
+	for (int32 tid : RegionTriangles)
+	{
+		FIndex3i Tri = TargetMesh.GetTriangle(tid);
+		GridBounds.Contain(TargetMesh.GetVertex(Tri.A));
+		GridBounds.Contain(TargetMesh.GetVertex(Tri.B));
+		GridBounds.Contain(TargetMesh.GetVertex(Tri.C));
+	}
+	GridBounds.Expand(CellSize);
+
+	// large triangles near the cut would make the grid (and the cost) unbounded, in that case give up
+	const double MaxCellsPerAxis = 4.0 * VoxelResolution;
+	if (GridBounds.Width() > MaxCellsPerAxis * CellSize || GridBounds.Height() > MaxCellsPerAxis * CellSize || GridBounds.Depth() > MaxCellsPerAxis * CellSize)
+	{
+		return false;
+	}
+
+	auto IsTimeBudgetExceeded = [TimeBudgetSeconds, StartTime]()
+	{
+		return TimeBudgetSeconds > 0 && (FPlatformTime::Seconds() - StartTime) > TimeBudgetSeconds;
+	};
+
+	// Distances are only sampled in blocks near either surface, which are the only blocks the combined surface passes through.
+	// Any grid edge that crosses a surface has both samples within one cell diagonal of it.
+	const double BandWidth = 3.0 * CellSize;
+	FSparseFieldGrid TargetGrid, ToolGrid, CombinedGrid;
+	TargetGrid.Initialize(GridBounds, CellSize);
+	ToolGrid.Initialize(GridBounds, CellSize);
+	if (SampleSignedDistance(TargetSpatial, TargetWinding, TargetGrid, BandWidth, 0.5, 0.0, IsTimeBudgetExceeded) == false
+		|| IsTimeBudgetExceeded()
+		|| SampleSignedDistance(ToolSpatial, ToolWinding, ToolGrid, BandWidth, 0.5, 0.0, IsTimeBudgetExceeded) == false)
+	{
+		return false;
+	}
+	CombineFieldGrids(TargetGrid, ToolGrid, Operation == FMeshBoolean::EBooleanOp::Union, CombinedGrid);
+
+	// the surface is left open at the grid border, where it continues as the part of TargetMesh outside the region.
+	// The extracted surface faces along the gradient of the field, ie outwards.
+	FDynamicMesh3& PatchMesh = PatchOut.PatchMesh;
+	if (ExtractIsoSurface(CombinedGrid, 0.0, PatchMesh, IsTimeBudgetExceeded, false) == false)
+	{
+		return false;
+	}
+
+	// The grid also covers parts of TargetMesh outside the region, discard the patch triangles that duplicate them.
+	// What remains is the part of the patch that replaces the region, with a border roughly along the region border.
+	TSet<int32> RegionSet(RegionTriangles);
+	TArray<uint8> KeepTri;
+	KeepTri.SetNumZeroed(PatchMesh.MaxTriangleID());
+	ParallelFor(PatchMesh.MaxTriangleID(), [&](int32 tid)
+	{
+		if (PatchMesh.IsTriangle(tid))
+		{
+			IMeshSpatial::FQueryOptions QueryOptions;
+			QueryOptions.MaxDistance = CellSize;
+			double NearestDistSqr = 0;
+			int32 NearestTriID = TargetSpatial.FindNearestTriangle(PatchMesh.GetTriCentroid(tid), NearestDistSqr, QueryOptions);
+			KeepTri[tid] = (NearestTriID >= 0 && RegionSet.Contains(NearestTriID) == false) ? 0 : 1;
+		}
+	});
+	TArray<int32> RemovePatchTriangles;
+	for (int32 tid : PatchMesh.TriangleIndicesItr())
+	{
+		if (KeepTri[tid] == 0)
+		{
+			RemovePatchTriangles.Add(tid);
+		}
+	}
+	FDynamicMeshEditor PatchEditor(&PatchMesh);
+	PatchEditor.RemoveTriangles(RemovePatchTriangles, true);
+	if (TargetMesh.HasAttributes())
+	{
+		PatchMesh.EnableAttributes();
+		RTGUtils::InitializeOverlayToPerVertexNormals(PatchMesh.Attributes()->PrimaryNormals());
+	}
+
+	return true;
+}
+
+
+void RTGUtils::ApplyLocalizedVoxelBooleanPatch(
+	FDynamicMesh3& TargetMesh,
+	const FLocalizedVoxelBooleanPatch& Patch,
+	TArray<int32>* NewTrianglesOut)
+{
+	const TArray<int32>& RegionTriangles = Patch.RegionTriangles;
+	const FDynamicMesh3& PatchMesh = Patch.PatchMesh;
+	if (RegionTriangles.Num() == 0)
+	{
+		FDynamicMeshEditor Editor(&TargetMesh);
+		FMeshIndexMappings PatchMappings;
+		Editor.AppendMesh(&PatchMesh, PatchMappings);
+		if (NewTrianglesOut != nullptr)
+		{
+			for (int32 tid : PatchMesh.TriangleIndicesItr())
+			{
+				NewTrianglesOut->Add(PatchMappings.GetNewTriangle(tid));
+			}
+		}
+		return;
+	}
+
+	// the edges of the region triangles that remain after removing them are the border of the hole
+	TSet<int32> RegionEdges;
+	for (int32 tid : RegionTriangles)
+	{
+		FIndex3i TriEdges = TargetMesh.GetTriEdges(tid);
+		RegionEdges.Add(TriEdges.A);
+		RegionEdges.Add(TriEdges.B);
+		RegionEdges.Add(TriEdges.C);
+	}
+
+	FDynamicMeshEditor Editor(&TargetMesh);
+	Editor.RemoveTriangles(RegionTriangles, true);
+	FMeshIndexMappings PatchMappings;
+	Editor.AppendMesh(&PatchMesh, PatchMappings);
+
+	TArray<int32> NewTriangles;
+	TArray<int32> HoleEdges, PatchEdges;
+	for (int32 eid : RegionEdges)
+	{
+		if (TargetMesh.IsEdge(eid) && TargetMesh.IsBoundaryEdge(eid))
+		{
+			HoleEdges.Add(eid);
+		}
+	}
+	for (int32 tid : PatchMesh.TriangleIndicesItr())
+	{
+		int32 NewTriID = PatchMappings.GetNewTriangle(tid);
+		NewTriangles.Add(NewTriID);
+		FIndex3i TriEdges = TargetMesh.GetTriEdges(NewTriID);
+		for (int32 j = 0; j < 3; ++j)
+		{
+			if (TargetMesh.IsBoundaryEdge(TriEdges[j]))
+			{
+				PatchEdges.Add(TriEdges[j]);
+			}
+		}
+	}
+
+	// zipper each patch loop to the nearest hole loop
+	TArray<TArray<int32>> HoleLoops, PatchLoops;
+	FindBoundaryLoops(TargetMesh, HoleEdges, HoleLoops);
+	FindBoundaryLoops(TargetMesh, PatchEdges, PatchLoops);
+	auto LoopCentroid = [&TargetMesh](const TArray<int32>& Loop)
+	{
+		FVector3d Centroid = FVector3d::Zero();
+		for (int32 vid : Loop)
+		{
+			Centroid += TargetMesh.GetVertex(vid);
+		}
+		return Centroid / (double)Loop.Num();
+	};
+	TArray<bool> HoleLoopUsed;
+	HoleLoopUsed.Init(false, HoleLoops.Num());
+	TArray<int32> StitchTriangles;
+	for (const TArray<int32>& PatchLoop : PatchLoops)
+	{
+		FVector3d PatchCentroid = LoopCentroid(PatchLoop);
+		int32 NearestHoleLoop = -1;
+		double MinDistSqr = TNumericLimits<double>::Max();
+		for (int32 k = 0; k < HoleLoops.Num(); ++k)
+		{
+			double DistSqr = (HoleLoopUsed[k]) ? TNumericLimits<double>::Max() : PatchCentroid.DistanceSquared(LoopCentroid(HoleLoops[k]));
+			if (DistSqr < MinDistSqr)
+			{
+				MinDistSqr = DistSqr;
+				NearestHoleLoop = k;
+			}
+		}
+		if (NearestHoleLoop >= 0)
+		{
+			HoleLoopUsed[NearestHoleLoop] = true;
+			ZipperLoops(TargetMesh, HoleLoops[NearestHoleLoop], PatchLoop, StitchTriangles);
+		}
+	}
+	SetMissingFaceNormals(TargetMesh, StitchTriangles);
+	NewTriangles.Append(StitchTriangles);
+
+	// fill any openings the zippering could not close, and hole loops without a matching patch loop
+	TArray<int32> FillCandidates = NewTriangles;
+	for (int32 k = 0; k < HoleLoops.Num(); ++k)
+	{
+		if (HoleLoopUsed[k] == false)
+		{
+			TArray<int32> HoleTriangles;
+			TargetMesh.GetVtxTriangles(HoleLoops[k][0], HoleTriangles, false);
+			FillCandidates.Append(HoleTriangles);
+		}
+	}
+	FillHolesAroundTriangles(TargetMesh, FillCandidates);
+
+	if (NewTrianglesOut != nullptr)
+	{
+		NewTrianglesOut->Append(NewTriangles);
+	}
+}
+
+
+
+bool RTGUtils::ComputeLocalizedVoxelBoolean(
+	FDynamicMesh3& TargetMesh,
+	FDynamicMeshAABBTree3& TargetSpatial,
+	TFastWindingTree<FDynamicMesh3>& TargetWinding,
+	const FDynamicMesh3& ToolMesh,
+	const FTransform3d& ToolTransform,
+	FMeshBoolean::EBooleanOp Operation,
+	int32 VoxelResolution,
+	double TimeBudgetSeconds,
+	double RegionExpansion,
+	TArray<int32>* NewTrianglesOut)
+{
+	FLocalizedVoxelBooleanPatch Patch;
+	if (ComputeLocalizedVoxelBooleanPatch(TargetMesh, TargetSpatial, TargetWinding, ToolMesh, ToolTransform, Operation, Patch,
+		VoxelResolution, TimeBudgetSeconds, RegionExpansion) == false)
+	{
+		return false;
+	}
+	ApplyLocalizedVoxelBooleanPatch(TargetMesh, Patch, NewTrianglesOut);
+	return true;
+}
+
+
+
+void RTGUtils::FillHolesAroundTriangles(FDynamicMesh3& Mesh, const TArray<int32>& Triangles)
+{
+	TSet<int32> CandidateEdges;
+	for (int32 tid : Triangles)
+	{
+		if (Mesh.IsTriangle(tid))
+		{
+			FIndex3i TriEdges = Mesh.GetTriEdges(tid);
+			for (int32 j = 0; j < 3; ++j)
+			{
+				if (Mesh.IsBoundaryEdge(TriEdges[j]))
+				{
+					CandidateEdges.Add(TriEdges[j]);
+				}
+			}
+		}
+	}
+	if (CandidateEdges.Num() == 0)
+	{
+		return;
+	}
+
+	bool bFilledAny = false;
+	FMeshBoundaryLoops LoopsCalc(&Mesh);
+	for (const FEdgeLoop& Loop : LoopsCalc.Loops)
+	{
+		bool bTouchesCandidate = false;
+		for (int32 eid : Loop.Edges)
+		{
+			if (CandidateEdges.Contains(eid))
+			{
+				bTouchesCandidate = true;
+				break;
+			}
+		}
+		if (bTouchesCandidate)
+		{
+			FMinimalHoleFiller Filler(&Mesh, Loop);
+			Filler.Fill();
+			bFilledAny = true;
+		}
+	}
+
+	// the hole filler does not set normals. Triangle IDs may be re-used, so all triangles have to be checked.
+	TArray<int32> AllTriangles;
+	if (bFilledAny && Mesh.HasAttributes())
+	{
+		for (int32 tid : Mesh.TriangleIndicesItr())
+		{
+			AllTriangles.Add(tid);
+		}
+	}
+	SetMissingFaceNormals(Mesh, AllTriangles);
+}
+
+
+
+
+bool RTGUtils::CombineMeshesWithBoolean(
+	const TArray<const FDynamicMesh3*>& Meshes,
+	const TArray<FTransform3d>& Transforms,
+	FMeshBoolean::EBooleanOp Operation,
+	FDynamicMesh3& ResultOut)
+{
+	if (!ensure(Meshes.Num() > 0 && Meshes.Num() == Transforms.Num()))
+	{
+		return false;
+	}
+	ensure(Operation == FMeshBoolean::EBooleanOp::Union || Operation == FMeshBoolean::EBooleanOp::Intersect);
+
+	// an operand at a level of the reduction is either one of the input meshes, or the owned result of a Boolean at the previous level
+	struct FOperand
+	{
+		const FDynamicMesh3* Mesh;
+		FTransform3d Transform;
+		TUniquePtr<FDynamicMesh3> OwnedMesh;
+	};
+
+	TArray<FOperand> Operands;
+	for (int32 k = 0; k < Meshes.Num(); ++k)
+	{
+		Operands.Add(FOperand{ Meshes[k], Transforms[k], nullptr });
+	}
+
+	bool bAllOK = true;
+	while (Operands.Num() > 1)
+	{
+		int32 NumPairs = Operands.Num() / 2;
+		TArray<FOperand> NextOperands;
+		NextOperands.SetNum(NumPairs);
+		TArray<bool> PairOK;
+		PairOK.Init(true, NumPairs);
+
+		ParallelFor(NumPairs, [&](int32 k)
+		{
+			const FOperand& A = Operands[2*k];
+			const FOperand& B = Operands[2*k + 1];
+			FOperand& Combined = NextOperands[k];
+			Combined.OwnedMesh = MakeUnique<FDynamicMesh3>();
+			Combined.Mesh = Combined.OwnedMesh.Get();
+			Combined.Transform = FTransform3d::Identity();
+
+			FMeshBoolean Boolean(A.Mesh, A.Transform, B.Mesh, B.Transform, Combined.OwnedMesh.Get(), Operation);
+			Boolean.bPutResultInInputSpace = true;
+			PairOK[k] = Boolean.Compute();
+		});
+
+		for (bool bPairOK : PairOK)
+		{
+			bAllOK = bAllOK && bPairOK;
+		}
+
+		// odd operand is passed up to the next level unmodified
+		if (Operands.Num() % 2 == 1)
+		{
+			NextOperands.Add(MoveTemp(Operands.Last()));
+		}
+		Operands = MoveTemp(NextOperands);
+	}
+
+	FOperand& Final = Operands[0];
+	if (Final.OwnedMesh.IsValid())
+	{
+		ResultOut = MoveTemp(*Final.OwnedMesh);
+	}
+	else
+	{
+		ResultOut = *Final.Mesh;
+		MeshTransforms::ApplyTransform(ResultOut, Final.Transform);
+	}
+
+	return bAllOK;
+}
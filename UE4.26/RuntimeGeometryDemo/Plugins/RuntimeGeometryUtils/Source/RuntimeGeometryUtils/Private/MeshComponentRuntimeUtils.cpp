@@ -1,7 +1,7 @@
 #include "MeshComponentRuntimeUtils.h"
 
 #include "DynamicMeshAttributeSet.h"
-#include "MeshNormals.h"
+#include "MeshNormalsRuntimeUtils.h"
 
 #include "DynamicMeshToMeshDescription.h"
 #include "StaticMeshAttributes.h"
@@ -54,12 +54,12 @@ void RTGUtils::UpdatePMCFromDynamicMesh_SplitTriangles(
 	Vertices.SetNumUninitialized(NumVertices);
 	Normals.SetNumUninitialized(NumVertices);
 
-	FMeshNormals PerVertexNormals(Mesh);
+	TArray<FVector3d> PerVertexNormals;
 	bool bUsePerVertexNormals = false;
 	const FDynamicMeshNormalOverlay* NormalOverlay = nullptr;
 	if (Mesh->HasAttributes() == false && bUseFaceNormals == false)
 	{
-		PerVertexNormals.ComputeVertexNormals();
+		RTGUtils::ComputeVertexNormals(*Mesh, PerVertexNormals);
 		bUsePerVertexNormals = true;
 	}
 	else if (Mesh->HasAttributes())
@@ -146,3 +146,76 @@ void RTGUtils::UpdatePMCFromDynamicMesh_SplitTriangles(
 
 	Component->CreateMeshSection_LinearColor(0, Vertices, Triangles, Normals, UV0, VtxColors, Tangents, bCreateCollision);
 }
+
+
+
+
+bool RTGUtils::UpdatePMCPositionsFromDynamicMesh_SplitTriangles(
+	UProceduralMeshComponent* Component,
+	const FDynamicMesh3* Mesh,
+	bool bUpdateNormals,
+	bool bUseFaceNormals)
+{
+	int32 NumTriangles = Mesh->TriangleCount();
+	int32 NumVertices = NumTriangles * 3;
+	FProcMeshSection* Section = (Component->GetNumSections() > 0) ? Component->GetProcMeshSection(0) : nullptr;
+	if (Section == nullptr || Section->ProcVertexBuffer.Num() != NumVertices)
+	{
+		return false;
+	}
+
+	const FDynamicMeshNormalOverlay* NormalOverlay = (Mesh->HasAttributes() && bUseFaceNormals == false) ? Mesh->Attributes()->PrimaryNormals() : nullptr;
+	TArray<FVector3d> PerVertexNormals;
+	if (bUpdateNormals && Mesh->HasAttributes() == false && bUseFaceNormals == false)
+	{
+		RTGUtils::ComputeVertexNormals(*Mesh, PerVertexNormals);
+	}
+
+	TArray<FVector> Vertices, Normals;
+	Vertices.SetNumUninitialized(NumVertices);
+	if (bUpdateNormals)
+	{
+		Normals.SetNumUninitialized(NumVertices);
+	}
+
+	// vertices are in the same order as in UpdatePMCFromDynamicMesh_SplitTriangles()
+	FVector3d Position[3];
+	FVector3f Normal[3];
+	int32 BufferIndex = 0;
+	for (int32 tid : Mesh->TriangleIndicesItr())
+	{
+		int32 k = 3 * (BufferIndex++);
+
+		Mesh->GetTriVertices(tid, Position[0], Position[1], Position[2]);
+		Vertices[k] = (FVector)Position[0];
+		Vertices[k+1] = (FVector)Position[1];
+		Vertices[k+2] = (FVector)Position[2];
+
+		if (bUpdateNormals)
+		{
+			if (PerVertexNormals.Num() > 0)
+			{
+				FIndex3i TriVerts = Mesh->GetTriangle(tid);
+				Normals[k] = (FVector)PerVertexNormals[TriVerts.A];
+				Normals[k+1] = (FVector)PerVertexNormals[TriVerts.B];
+				Normals[k+2] = (FVector)PerVertexNormals[TriVerts.C];
+			}
+			else if (NormalOverlay != nullptr)
+			{
+				NormalOverlay->GetTriElements(tid, Normal[0], Normal[1], Normal[2]);
+				Normals[k] = (FVector)Normal[0];
+				Normals[k+1] = (FVector)Normal[1];
+				Normals[k+2] = (FVector)Normal[2];
+			}
+			else
+			{
+				FVector3d TriNormal = Mesh->GetTriNormal(tid);
+				Normals[k] = Normals[k+1] = Normals[k+2] = (FVector)TriNormal;
+			}
+		}
+	}
+
+	// empty arrays are left unmodified by UpdateMeshSection
+	Component->UpdateMeshSection_LinearColor(0, Vertices, Normals, TArray<FVector2D>(), TArray<FLinearColor>(), TArray<FProcMeshTangent>());
+	return true;
+}
@@ -0,0 +1,456 @@
+#include "MeshFieldRuntimeUtils.h"
+
+#include "SparseImplicitRuntimeUtils.h"
+#include "Async/ParallelFor.h"
+#include "HAL/ThreadSafeBool.h"
+
+
+namespace
+{
+	// samples along each axis of the blocks that dense grids are processed in
+	const int32 DenseSamplingBlockSize = 8;
+}
+
+
+void RTGUtils::FDenseFieldGrid::Initialize(const FAxisAlignedBox3d& Bounds, double CellSizeIn)
+{
+	CellSize = FMathd::Max(CellSizeIn, FMathd::ZeroTolerance);
+	Origin = Bounds.Min;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		Dimensions[j] = FMath::Max(1, (int32)FMathd::Ceil((Bounds.Max[j] - Bounds.Min[j]) / CellSize) + 1);
+	}
+	Values.SetNumUninitialized(NumSamples());
+}
+
+
+void RTGUtils::FSparseFieldGrid::Initialize(const FAxisAlignedBox3d& Bounds, double CellSizeIn, int32 BlockSizeIn)
+{
+	CellSize = FMathd::Max(CellSizeIn, FMathd::ZeroTolerance);
+	BlockSize = FMath::Max(BlockSizeIn, 1);
+	Origin = Bounds.Min;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		int32 NumSamples = FMath::Max(1, (int32)FMathd::Ceil((Bounds.Max[j] - Bounds.Min[j]) / CellSize) + 1);
+		NumBlocks[j] = (NumSamples + BlockSize - 1) / BlockSize;
+		Dimensions[j] = NumBlocks[j] * BlockSize;
+	}
+	BlockDataIndex.Init(-1, TotalBlocks());
+	BlockUniformValue.Init(0.0f, TotalBlocks());
+	BlockValues.Reset();
+}
+
+
+float RTGUtils::FSparseFieldGrid::GetValue(const FVector3i& Index) const
+{
+	FVector3i BlockCoords(Index.X / BlockSize, Index.Y / BlockSize, Index.Z / BlockSize);
+	int32 BlockID = BlockCoords.X + NumBlocks.X * (BlockCoords.Y + NumBlocks.Y * BlockCoords.Z);
+	int32 DataIndex = BlockDataIndex[BlockID];
+	if (DataIndex < 0)
+	{
+		return BlockUniformValue[BlockID];
+	}
+	FVector3i Local = Index - BlockCoords * BlockSize;
+	return BlockValues[DataIndex][Local.X + BlockSize * (Local.Y + BlockSize * Local.Z)];
+}
+
+
+
+/**
+ * Compute the signed distance for the samples [FirstIndex, FirstIndex+Count) of a grid in scanline order.
+ * Each nearest-triangle query is bounded by the distance of the previous sample plus the distance between the samples
+ * (starting from the block center), which is an upper bound on the new distance.
+ * @param bUniformSign if true, BlockSign is used for all samples rather than evaluating the winding number
+ */
+static void SampleBlockSignedDistance(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	double WindingThreshold,
+	const FVector3d& CenterPosition,
+	double CenterDistance,
+	bool bUniformSign,
+	double BlockSign,
+	const FVector3i& FirstIndex,
+	const FVector3i& Count,
+	TFunctionRef<FVector3d(const FVector3i&)> GetPosition,
+	TFunctionRef<void(const FVector3i&, double)> SetValue)
+{
+	FVector3d PrevPosition = CenterPosition;
+	double PrevDistance = CenterDistance;
+	for (int32 k = 0; k < Count.Z; ++k)
+	{
+		for (int32 j = 0; j < Count.Y; ++j)
+		{
+			for (int32 i = 0; i < Count.X; ++i)
+			{
+				FVector3i Index = FirstIndex + FVector3i(i, j, k);
+				FVector3d Position = GetPosition(Index);
+
+				IMeshSpatial::FQueryOptions QueryOptions;
+				QueryOptions.MaxDistance = PrevDistance + Position.Distance(PrevPosition) + FMathd::ZeroTolerance;
+				double NearestDistSqr = 0;
+				if (Spatial.FindNearestTriangle(Position, NearestDistSqr, QueryOptions) < 0)
+				{
+					// only possible due to round-off
+					Spatial.FindNearestTriangle(Position, NearestDistSqr);
+				}
+				double Distance = FMathd::Sqrt(NearestDistSqr);
+
+				double Sign = BlockSign;
+				if (bUniformSign == false)
+				{
+					Sign = (Winding.FastWindingNumber(Position) > WindingThreshold) ? -1.0 : 1.0;
+				}
+				SetValue(Index, Sign * Distance);
+
+				PrevPosition = Position;
+				PrevDistance = Distance;
+			}
+		}
+	}
+}
+
+
+void RTGUtils::SampleSignedDistance(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	FDenseFieldGrid& Grid,
+	double WindingThreshold)
+{
+	const FVector3i Dimensions = Grid.Dimensions;
+	FVector3i NumBlocks;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		NumBlocks[j] = (Dimensions[j] + DenseSamplingBlockSize - 1) / DenseSamplingBlockSize;
+	}
+	int32 TotalBlocks = NumBlocks.X * NumBlocks.Y * NumBlocks.Z;
+
+	ParallelFor(TotalBlocks, [&](int32 BlockID)
+	{
+		FVector3i BlockCoords(BlockID % NumBlocks.X, (BlockID / NumBlocks.X) % NumBlocks.Y, BlockID / (NumBlocks.X * NumBlocks.Y));
+		FVector3i FirstIndex = BlockCoords * DenseSamplingBlockSize;
+		FVector3i Count;
+		for (int32 j = 0; j < 3; ++j)
+		{
+			Count[j] = FMath::Min(DenseSamplingBlockSize, Dimensions[j] - FirstIndex[j]);
+		}
+		FVector3d BlockMin = Grid.GetPosition(FirstIndex);
+		FVector3d BlockMax = Grid.GetPosition(FirstIndex + Count - FVector3i(1, 1, 1));
+		FVector3d Center = 0.5 * (BlockMin + BlockMax);
+		double HalfDiagonal = 0.5 * BlockMin.Distance(BlockMax);
+
+		double CenterDistSqr = 0;
+		Spatial.FindNearestTriangle(Center, CenterDistSqr);
+		double CenterDistance = FMathd::Sqrt(CenterDistSqr);
+		// if the surface does not pass through the block, the sign is the same for all samples
+		bool bUniformSign = CenterDistance > HalfDiagonal;
+		double BlockSign = (bUniformSign && Winding.FastWindingNumber(Center) > WindingThreshold) ? -1.0 : 1.0;
+
+		SampleBlockSignedDistance(Spatial, Winding, WindingThreshold, Center, CenterDistance, bUniformSign, BlockSign, FirstIndex, Count,
+			[&Grid](const FVector3i& Index) { return Grid.GetPosition(Index); },
+			[&Grid](const FVector3i& Index, double Value) { Grid.Values[Grid.ToLinearIndex(Index)] = (float)Value; });
+	});
+}
+
+
+bool RTGUtils::SampleSignedDistance(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	FSparseFieldGrid& Grid,
+	double NarrowBandWidth,
+	double WindingThreshold,
+	double BandCenter,
+	TFunction<bool()> CancelF)
+{
+	const int32 BlockSize = Grid.BlockSize;
+	const int32 TotalBlocks = Grid.TotalBlocks();
+	const double HalfDiagonal = 0.5 * Grid.CellSize * (double)(BlockSize - 1) * FMathd::Sqrt(3.0);
+	const double BandMin = BandCenter - NarrowBandWidth, BandMax = BandCenter + NarrowBandWidth;
+	auto GetBlockCenter = [&](int32 BlockID)
+	{
+		FVector3i FirstIndex = Grid.GetBlockCoords(BlockID) * BlockSize;
+		return 0.5 * (Grid.GetPosition(FirstIndex) + Grid.GetPosition(FirstIndex + FVector3i(BlockSize - 1, BlockSize - 1, BlockSize - 1)));
+	};
+
+	// find the blocks that the narrow band passes through. The search radius is bounded, so queries for the other blocks terminate early.
+	TArray<double> CenterDistances;
+	CenterDistances.SetNumUninitialized(TotalBlocks);
+	TArray<double> BlockSigns;
+	BlockSigns.SetNumUninitialized(TotalBlocks);
+	Grid.BlockDataIndex.Init(-1, TotalBlocks);
+	Grid.BlockUniformValue.Init(0.0f, TotalBlocks);
+	FThreadSafeBool bCancelled = false;
+	ParallelFor(TotalBlocks, [&](int32 BlockID)
+	{
+		if (bCancelled || (CancelF && CancelF()))
+		{
+			bCancelled = true;
+			return;
+		}
+		FVector3d Center = GetBlockCenter(BlockID);
+		IMeshSpatial::FQueryOptions QueryOptions;
+		QueryOptions.MaxDistance = HalfDiagonal + FMathd::Abs(BandCenter) + NarrowBandWidth;
+		double NearestDistSqr = 0;
+		bool bFound = Spatial.FindNearestTriangle(Center, NearestDistSqr, QueryOptions) >= 0;
+		double Distance = (bFound) ? FMathd::Sqrt(NearestDistSqr) : QueryOptions.MaxDistance;
+		CenterDistances[BlockID] = Distance;
+
+		// range of the signed distance of the samples of the block
+		double RangeMin = -(Distance + HalfDiagonal), RangeMax = Distance + HalfDiagonal;
+		BlockSigns[BlockID] = 1.0;
+		if (Distance > HalfDiagonal)
+		{
+			// the surface does not pass through the block, so the sign is the same for all samples
+			BlockSigns[BlockID] = (Winding.FastWindingNumber(Center) > WindingThreshold) ? -1.0 : 1.0;
+			RangeMin = (BlockSigns[BlockID] > 0) ? (Distance - HalfDiagonal) : RangeMin;
+			RangeMax = (BlockSigns[BlockID] > 0) ? RangeMax : -(Distance - HalfDiagonal);
+		}
+
+		// samples at the ends of the band are clamped to them anyway, so a block that only touches the band is uniform
+		if (RangeMax <= BandMin)
+		{
+			Grid.BlockUniformValue[BlockID] = (float)BandMin;
+		}
+		else if (RangeMin >= BandMax)
+		{
+			Grid.BlockUniformValue[BlockID] = (float)BandMax;
+		}
+		else
+		{
+			Grid.BlockDataIndex[BlockID] = 0;
+		}
+	});
+	if (bCancelled)
+	{
+		return false;
+	}
+
+	TArray<int32> AllocatedBlocks;
+	for (int32 BlockID = 0; BlockID < TotalBlocks; ++BlockID)
+	{
+		if (Grid.BlockDataIndex[BlockID] >= 0)
+		{
+			Grid.BlockDataIndex[BlockID] = AllocatedBlocks.Num();
+			AllocatedBlocks.Add(BlockID);
+		}
+	}
+	Grid.BlockValues.Reset();
+	Grid.BlockValues.SetNum(AllocatedBlocks.Num());
+
+	ParallelFor(AllocatedBlocks.Num(), [&](int32 k)
+	{
+		if (bCancelled || (CancelF && CancelF()))
+		{
+			bCancelled = true;
+			return;
+		}
+		int32 BlockID = AllocatedBlocks[k];
+		FVector3i FirstIndex = Grid.GetBlockCoords(BlockID) * BlockSize;
+		TArray<float>& Values = Grid.BlockValues[k];
+		Values.SetNumUninitialized(BlockSize * BlockSize * BlockSize);
+
+		bool bUniformSign = CenterDistances[BlockID] > HalfDiagonal;
+		SampleBlockSignedDistance(Spatial, Winding, WindingThreshold, GetBlockCenter(BlockID), CenterDistances[BlockID], bUniformSign, BlockSigns[BlockID],
+			FirstIndex, FVector3i(BlockSize, BlockSize, BlockSize),
+			[&Grid](const FVector3i& Index) { return Grid.GetPosition(Index); },
+			[&](const FVector3i& Index, double Value)
+			{
+				FVector3i Local = Index - FirstIndex;
+				Values[Local.X + BlockSize * (Local.Y + BlockSize * Local.Z)] = (float)FMathd::Clamp(Value, BandMin, BandMax);
+			});
+	});
+	return (bCancelled == false);
+}
+
+
+void RTGUtils::SampleWindingNumber(
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	FDenseFieldGrid& Grid)
+{
+	// one z-slice per task, so that consecutive samples of a task are spatially coherent
+	ParallelFor(Grid.Dimensions.Z, [&](int32 k)
+	{
+		for (int32 j = 0; j < Grid.Dimensions.Y; ++j)
+		{
+			for (int32 i = 0; i < Grid.Dimensions.X; ++i)
+			{
+				FVector3i Index(i, j, k);
+				Grid.Values[Grid.ToLinearIndex(Index)] = (float)Winding.FastWindingNumber(Grid.GetPosition(Index));
+			}
+		}
+	});
+}
+
+
+
+/** @return index of the grid sample nearest to Position, and set bOnSample to true if Position is (up to round-off) at that sample */
+static FVector3i NearestSampleIndex(const FVector3d& Origin, double CellSize, const FVector3d& Position, bool& bOnSample)
+{
+	FVector3i Index;
+	bOnSample = true;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		double GridCoord = (Position[j] - Origin[j]) / CellSize;
+		double Rounded = FMathd::Floor(GridCoord + 0.5);
+		bOnSample = bOnSample && FMathd::Abs(GridCoord - Rounded) < 1e-3;
+		Index[j] = (int32)Rounded;
+	}
+	return Index;
+}
+
+
+/** @return Index clamped to the samples of a grid with the given dimensions */
+static FVector3i ClampSampleIndex(const FVector3i& Index, const FVector3i& Dimensions)
+{
+	return FVector3i(FMath::Clamp(Index.X, 0, Dimensions.X - 1), FMath::Clamp(Index.Y, 0, Dimensions.Y - 1), FMath::Clamp(Index.Z, 0, Dimensions.Z - 1));
+}
+
+
+/** @return true if the samples in the index range [Min, Max] are not all on the same side of IsoValue */
+static bool SamplesSpanIsoValue(const FVector3i& Min, const FVector3i& Max, double IsoValue, TFunctionRef<float(const FVector3i&)> GetValue)
+{
+	bool bAnyInside = false, bAnyOutside = false;
+	for (int32 k = Min.Z; k <= Max.Z; ++k)
+	{
+		for (int32 j = Min.Y; j <= Max.Y; ++j)
+		{
+			for (int32 i = Min.X; i <= Max.X; ++i)
+			{
+				bool bInside = GetValue(FVector3i(i, j, k)) < IsoValue;
+				bAnyInside = bAnyInside || bInside;
+				bAnyOutside = bAnyOutside || !bInside;
+				if (bAnyInside && bAnyOutside)
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+
+void RTGUtils::ExtractIsoSurface(
+	const FDenseFieldGrid& Grid,
+	double IsoValue,
+	FDynamicMesh3& MeshOut,
+	TFunction<double(const FVector3d&)> RefineFieldF,
+	int32 RootRefinementSteps)
+{
+	auto GetValue = [&Grid](const FVector3i& Index) { return Grid.Values[Grid.ToLinearIndex(ClampSampleIndex(Index, Grid.Dimensions))]; };
+	auto Field = [&](const FVector3d& Position)
+	{
+		bool bOnSample = false;
+		FVector3i Index = NearestSampleIndex(Grid.Origin, Grid.CellSize, Position, bOnSample);
+		// only the root refinement evaluates positions between the samples
+		return (bOnSample || !RefineFieldF) ? ((double)GetValue(Index) - IsoValue) : (RefineFieldF(Position) - IsoValue);
+	};
+	auto SeedBlock = [&](const FAxisAlignedBox3d& BlockBounds)
+	{
+		bool bOnSample = false;
+		FVector3i Min = ClampSampleIndex(NearestSampleIndex(Grid.Origin, Grid.CellSize, BlockBounds.Min, bOnSample), Grid.Dimensions);
+		FVector3i Max = ClampSampleIndex(NearestSampleIndex(Grid.Origin, Grid.CellSize, BlockBounds.Max, bOnSample), Grid.Dimensions);
+		return SamplesSpanIsoValue(Min, Max, IsoValue, GetValue);
+	};
+
+	FAxisAlignedBox3d Bounds(Grid.Origin, Grid.GetPosition(Grid.Dimensions - FVector3i(1, 1, 1)));
+	ExtractSparseIsoSurface(Field, SeedBlock, Bounds, Grid.CellSize, MeshOut, (RefineFieldF) ? RootRefinementSteps : 0);
+}
+
+
+bool RTGUtils::ExtractIsoSurface(
+	const FSparseFieldGrid& Grid,
+	double IsoValue,
+	FDynamicMesh3& MeshOut,
+	TFunction<bool()> CancelF,
+	bool bCloseAtGridBorder)
+{
+	auto GetValue = [&Grid](const FVector3i& Index) { return Grid.GetValue(ClampSampleIndex(Index, Grid.Dimensions)); };
+	auto Field = [&](const FVector3d& Position)
+	{
+		bool bOnSample = false;
+		return (double)GetValue(NearestSampleIndex(Grid.Origin, Grid.CellSize, Position, bOnSample)) - IsoValue;
+	};
+	auto SeedBlock = [&](const FAxisAlignedBox3d& BlockBounds)
+	{
+		bool bOnSample = false;
+		FVector3i Min = ClampSampleIndex(NearestSampleIndex(Grid.Origin, Grid.CellSize, BlockBounds.Min, bOnSample), Grid.Dimensions);
+		FVector3i Max = ClampSampleIndex(NearestSampleIndex(Grid.Origin, Grid.CellSize, BlockBounds.Max, bOnSample), Grid.Dimensions);
+
+		// the unallocated blocks are all on one side of the surface, so only scan the samples if an allocated block overlaps the range
+		bool bAnyAllocated = false;
+		for (int32 bk = Min.Z / Grid.BlockSize; bk <= Max.Z / Grid.BlockSize; ++bk)
+		{
+			for (int32 bj = Min.Y / Grid.BlockSize; bj <= Max.Y / Grid.BlockSize; ++bj)
+			{
+				for (int32 bi = Min.X / Grid.BlockSize; bi <= Max.X / Grid.BlockSize; ++bi)
+				{
+					bAnyAllocated = bAnyAllocated || Grid.BlockDataIndex[bi + Grid.NumBlocks.X * (bj + Grid.NumBlocks.Y * bk)] >= 0;
+				}
+			}
+		}
+		return bAnyAllocated && SamplesSpanIsoValue(Min, Max, IsoValue, GetValue);
+	};
+
+	FAxisAlignedBox3d Bounds(Grid.Origin, Grid.GetPosition(Grid.Dimensions - FVector3i(1, 1, 1)));
+	return ExtractSparseIsoSurface(Field, SeedBlock, Bounds, Grid.CellSize, MeshOut, 0, 8, CancelF, bCloseAtGridBorder);
+}
+
+
+void RTGUtils::ComputeDenseSolidify(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	int32 VoxelResolution,
+	double WindingThreshold,
+	double ExtendBounds,
+	FDynamicMesh3& ResultOut)
+{
+	FAxisAlignedBox3d MeshBounds = Spatial.GetBoundingBox();
+	double CellSize = FMathd::Max(MeshBounds.MaxDim() / (double)FMath::Max(VoxelResolution, 1), FMathf::ZeroTolerance);
+	FAxisAlignedBox3d GridBounds = MeshBounds;
+	GridBounds.Expand(FMathd::Max(ExtendBounds, 1.0) * CellSize);
+
+	FDenseFieldGrid Grid;
+	Grid.Initialize(GridBounds, CellSize);
+	SampleWindingNumber(Winding, Grid);
+
+	// winding number is above the threshold inside, so extract the zero isosurface of the threshold minus the winding number
+	ParallelFor(Grid.Dimensions.Z, [&](int32 k)
+	{
+		int64 SliceStart = (int64)k * Grid.Dimensions.X * Grid.Dimensions.Y;
+		for (int64 Index = SliceStart; Index < SliceStart + (int64)Grid.Dimensions.X * Grid.Dimensions.Y; ++Index)
+		{
+			Grid.Values[Index] = (float)WindingThreshold - Grid.Values[Index];
+		}
+	});
+	auto WindingField = [&Winding, WindingThreshold](const FVector3d& Pos)
+	{
+		return WindingThreshold - Winding.FastWindingNumber(Pos);
+	};
+
+	ResultOut = FDynamicMesh3();
+	ExtractIsoSurface(Grid, 0.0, ResultOut, WindingField, 3);
+}
+
+
+void RTGUtils::ComputeDenseOffset(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	double OffsetDistance,
+	int32 VoxelResolution,
+	FDynamicMesh3& ResultOut,
+	double WindingThreshold)
+{
+	FAxisAlignedBox3d MeshBounds = Spatial.GetBoundingBox();
+	double Dilation = FMathd::Max(OffsetDistance, 0.0);
+	double CellSize = FMathd::Max((MeshBounds.MaxDim() + 2.0 * Dilation) / (double)FMath::Max(VoxelResolution, 1), FMathf::ZeroTolerance);
+	FAxisAlignedBox3d GridBounds = MeshBounds;
+	GridBounds.Expand(Dilation + 2.0 * CellSize);
+
+	FDenseFieldGrid Grid;
+	Grid.Initialize(GridBounds, CellSize);
+	SampleSignedDistance(Spatial, Winding, Grid, WindingThreshold);
+
+	ResultOut = FDynamicMesh3();
+	ExtractIsoSurface(Grid, OffsetDistance, ResultOut);
+}
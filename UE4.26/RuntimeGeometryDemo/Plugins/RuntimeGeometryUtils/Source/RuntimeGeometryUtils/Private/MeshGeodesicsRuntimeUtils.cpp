@@ -0,0 +1,272 @@
+#include "MeshGeodesicsRuntimeUtils.h"
+
+#include "Async/ParallelFor.h"
+
+// UnrealMathUtility.h #defines PI and Eigen doesn't like this
+#ifdef PI
+#undef PI
+#endif
+
+THIRD_PARTY_INCLUDES_START
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+THIRD_PARTY_INCLUDES_END
+
+
+typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> FHeatGeodesicsSolver;
+
+/**
+ * Snapshot of the mesh geometry, indexed by compact vertex/triangle rows, and the factorized systems
+ */
+struct RTGUtils::FHeatGeodesics::FSolverData
+{
+	// vertex ID -> row, or -1 for unused IDs
+	TArray<int32> VertexRows;
+	// row -> vertex ID
+	TArray<int32> RowVertices;
+
+	TArray<FVector3d> Positions;
+	TArray<FIndex3i> Triangles;
+	// unit normal and area of each triangle
+	TArray<FVector3d> TriNormals;
+	TArray<double> TriAreas;
+	// cotangent of the angle at each corner of each triangle
+	TArray<FVector3d> TriCotangents;
+
+	// triangles around each vertex row, VertexTriangles[VertexTrianglesStart[Row]...VertexTrianglesStart[Row+1]-1]
+	TArray<int32> VertexTrianglesStart;
+	TArray<int32> VertexTriangles;
+
+	// factorization of (M + t*K) for the heat flow, K is the (positive semi-definite) cotangent Laplacian and M the lumped mass matrix
+	FHeatGeodesicsSolver HeatSolver;
+	// factorization of (K + epsilon*M) for the Poisson problem. K is singular, the small regularization makes it definite.
+	FHeatGeodesicsSolver PoissonSolver;
+};
+
+
+RTGUtils::FHeatGeodesics::FHeatGeodesics()
+{
+}
+
+RTGUtils::FHeatGeodesics::~FHeatGeodesics()
+{
+}
+
+
+bool RTGUtils::FHeatGeodesics::IsInitialized() const
+{
+	return Data.IsValid();
+}
+
+
+bool RTGUtils::FHeatGeodesics::Initialize(const FDynamicMesh3& Mesh, double TimeStepScale)
+{
+	Data.Reset();
+	TUniquePtr<FSolverData> NewData = MakeUnique<FSolverData>();
+	FSolverData& D = *NewData;
+
+	// compact vertex rows
+	D.VertexRows.Init(-1, Mesh.MaxVertexID());
+	D.RowVertices.Reserve(Mesh.VertexCount());
+	for (int32 vid : Mesh.VertexIndicesItr())
+	{
+		D.VertexRows[vid] = D.RowVertices.Num();
+		D.RowVertices.Add(vid);
+	}
+	int32 NumVertices = D.RowVertices.Num();
+	D.Triangles.Reserve(Mesh.TriangleCount());
+	for (int32 tid : Mesh.TriangleIndicesItr())
+	{
+		FIndex3i Tri = Mesh.GetTriangle(tid);
+		D.Triangles.Add(FIndex3i(D.VertexRows[Tri.A], D.VertexRows[Tri.B], D.VertexRows[Tri.C]));
+	}
+	int32 NumTriangles = D.Triangles.Num();
+	if (NumVertices == 0 || NumTriangles == 0)
+	{
+		return false;
+	}
+
+	D.Positions.SetNumUninitialized(NumVertices);
+	ParallelFor(NumVertices, [&](int32 Row)
+	{
+		D.Positions[Row] = Mesh.GetVertex(D.RowVertices[Row]);
+	});
+
+	// triangle normals, areas and cotangents
+	D.TriNormals.SetNumUninitialized(NumTriangles);
+	D.TriAreas.SetNumUninitialized(NumTriangles);
+	D.TriCotangents.SetNumUninitialized(NumTriangles);
+	ParallelFor(NumTriangles, [&](int32 TriRow)
+	{
+		const FIndex3i& Tri = D.Triangles[TriRow];
+		FVector3d AreaNormal = (D.Positions[Tri.B] - D.Positions[Tri.A]).Cross(D.Positions[Tri.C] - D.Positions[Tri.A]);
+		double DoubleArea = AreaNormal.Length();
+		D.TriAreas[TriRow] = 0.5 * DoubleArea;
+		D.TriNormals[TriRow] = (DoubleArea > FMathd::ZeroTolerance) ? (AreaNormal / DoubleArea) : FVector3d::Zero();
+		for (int32 j = 0; j < 3; ++j)
+		{
+			// cot = cos/sin = (u.v) / |u x v|
+			FVector3d U = D.Positions[Tri[(j + 1) % 3]] - D.Positions[Tri[j]];
+			FVector3d V = D.Positions[Tri[(j + 2) % 3]] - D.Positions[Tri[j]];
+			D.TriCotangents[TriRow][j] = (DoubleArea > FMathd::ZeroTolerance) ? (U.Dot(V) / DoubleArea) : 0.0;
+		}
+	});
+
+	// vertex-triangle adjacency, for parallel gathers over the one-rings
+	D.VertexTrianglesStart.Init(0, NumVertices + 1);
+	for (const FIndex3i& Tri : D.Triangles)
+	{
+		D.VertexTrianglesStart[Tri.A + 1]++;
+		D.VertexTrianglesStart[Tri.B + 1]++;
+		D.VertexTrianglesStart[Tri.C + 1]++;
+	}
+	for (int32 Row = 0; Row < NumVertices; ++Row)
+	{
+		D.VertexTrianglesStart[Row + 1] += D.VertexTrianglesStart[Row];
+	}
+	D.VertexTriangles.SetNumUninitialized(3 * NumTriangles);
+	TArray<int32> InsertPos(D.VertexTrianglesStart);
+	for (int32 TriRow = 0; TriRow < NumTriangles; ++TriRow)
+	{
+		const FIndex3i& Tri = D.Triangles[TriRow];
+		for (int32 j = 0; j < 3; ++j)
+		{
+			D.VertexTriangles[InsertPos[Tri[j]]++] = TriRow;
+		}
+	}
+
+	// cotangent Laplacian and lumped mass matrix
+	std::vector<Eigen::Triplet<double>> LaplacianEntries;
+	LaplacianEntries.reserve(12 * NumTriangles);
+	Eigen::VectorXd Mass = Eigen::VectorXd::Zero(NumVertices);
+	double EdgeLengthSum = 0;
+	for (int32 TriRow = 0; TriRow < NumTriangles; ++TriRow)
+	{
+		const FIndex3i& Tri = D.Triangles[TriRow];
+		for (int32 j = 0; j < 3; ++j)
+		{
+			// the angle at corner j is opposite to the edge (j+1, j+2)
+			int32 V1 = Tri[(j + 1) % 3], V2 = Tri[(j + 2) % 3];
+			double Weight = 0.5 * D.TriCotangents[TriRow][j];
+			LaplacianEntries.emplace_back(V1, V2, -Weight);
+			LaplacianEntries.emplace_back(V2, V1, -Weight);
+			LaplacianEntries.emplace_back(V1, V1, Weight);
+			LaplacianEntries.emplace_back(V2, V2, Weight);
+			Mass[Tri[j]] += D.TriAreas[TriRow] / 3.0;
+			EdgeLengthSum += D.Positions[V1].Distance(D.Positions[V2]);
+		}
+	}
+	Eigen::SparseMatrix<double> K(NumVertices, NumVertices);
+	K.setFromTriplets(LaplacianEntries.begin(), LaplacianEntries.end());
+	Eigen::SparseMatrix<double> M(NumVertices, NumVertices);
+	M.reserve(Eigen::VectorXi::Constant(NumVertices, 1));
+	for (int32 Row = 0; Row < NumVertices; ++Row)
+	{
+		M.insert(Row, Row) = Mass[Row];
+	}
+
+	// time step is h^2 for mean edge length h, as suggested in the paper
+	double MeanEdgeLength = EdgeLengthSum / (3.0 * NumTriangles);
+	double TimeStep = FMathd::Max(TimeStepScale, FMathd::ZeroTolerance) * MeanEdgeLength * MeanEdgeLength;
+	D.HeatSolver.compute(M + TimeStep * K);
+	if (D.HeatSolver.info() != Eigen::Success)
+	{
+		return false;
+	}
+
+	double Epsilon = 1e-8 * K.diagonal().sum() / FMathd::Max(Mass.sum(), FMathd::ZeroTolerance);
+	D.PoissonSolver.compute(K + Epsilon * M);
+	if (D.PoissonSolver.info() != Eigen::Success)
+	{
+		return false;
+	}
+
+	Data = MoveTemp(NewData);
+	return true;
+}
+
+
+bool RTGUtils::FHeatGeodesics::ComputeDistances(const TArray<int32>& SourceVertices, TArray<double>& DistancesOut) const
+{
+	if (Data.IsValid() == false)
+	{
+		return false;
+	}
+	const FSolverData& D = *Data;
+	int32 NumVertices = D.RowVertices.Num();
+	int32 NumTriangles = D.Triangles.Num();
+
+	TArray<int32> SourceRows;
+	Eigen::VectorXd Delta = Eigen::VectorXd::Zero(NumVertices);
+	for (int32 vid : SourceVertices)
+	{
+		if (D.VertexRows.IsValidIndex(vid) && D.VertexRows[vid] >= 0)
+		{
+			SourceRows.Add(D.VertexRows[vid]);
+			Delta[D.VertexRows[vid]] = 1.0;
+		}
+	}
+	if (SourceRows.Num() == 0)
+	{
+		return false;
+	}
+
+	// 1) heat flow from the sources for one time step
+	Eigen::VectorXd Heat = D.HeatSolver.solve(Delta);
+
+	// 2) normalized negative heat gradient in each triangle, which points away from the sources
+	TArray<FVector3d> TriField;
+	TriField.SetNumUninitialized(NumTriangles);
+	ParallelFor(NumTriangles, [&](int32 TriRow)
+	{
+		const FIndex3i& Tri = D.Triangles[TriRow];
+		FVector3d Gradient = FVector3d::Zero();
+		for (int32 j = 0; j < 3; ++j)
+		{
+			// edge opposite to corner j, oriented consistently with the triangle
+			FVector3d Edge = D.Positions[Tri[(j + 2) % 3]] - D.Positions[Tri[(j + 1) % 3]];
+			Gradient += Heat[Tri[j]] * D.TriNormals[TriRow].Cross(Edge);
+		}
+		// heat values far from the sources are tiny, so do not use Normalized(), which has a fixed epsilon
+		double Length = Gradient.Length();
+		TriField[TriRow] = (Length > 0) ? (-Gradient / Length) : FVector3d::Zero();
+	});
+
+	// 3) integrated divergence of the field at each vertex
+	Eigen::VectorXd Divergence(NumVertices);
+	ParallelFor(NumVertices, [&](int32 Row)
+	{
+		double Sum = 0;
+		for (int32 k = D.VertexTrianglesStart[Row]; k < D.VertexTrianglesStart[Row + 1]; ++k)
+		{
+			int32 TriRow = D.VertexTriangles[k];
+			const FIndex3i& Tri = D.Triangles[TriRow];
+			int32 j = (Tri.A == Row) ? 0 : ((Tri.B == Row) ? 1 : 2);
+			int32 j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			FVector3d Edge1 = D.Positions[Tri[j1]] - D.Positions[Row];
+			FVector3d Edge2 = D.Positions[Tri[j2]] - D.Positions[Row];
+			// each edge is weighted by the cotangent of the opposite angle
+			Sum += D.TriCotangents[TriRow][j2] * Edge1.Dot(TriField[TriRow]) + D.TriCotangents[TriRow][j1] * Edge2.Dot(TriField[TriRow]);
+		}
+		Divergence[Row] = 0.5 * Sum;
+	});
+
+	// 4) distance is the function whose gradient best matches the field, ie the solution of the Poisson problem L*Phi = Div (and K = -L)
+	Eigen::VectorXd Phi = D.PoissonSolver.solve(-Divergence);
+
+	// shift so the sources are at distance zero, and flip if the solution has the opposite sign
+	double SourceMean = 0;
+	for (int32 Row : SourceRows)
+	{
+		SourceMean += Phi[Row];
+	}
+	SourceMean /= (double)SourceRows.Num();
+	double Sign = (Phi.mean() - SourceMean < 0) ? -1.0 : 1.0;
+
+	DistancesOut.Init(0.0, D.VertexRows.Num());
+	ParallelFor(NumVertices, [&](int32 Row)
+	{
+		DistancesOut[D.RowVertices[Row]] = Sign * (Phi[Row] - SourceMean);
+	});
+	return true;
+}
@@ -0,0 +1,111 @@
+#include "MeshNormalsRuntimeUtils.h"
+
+#include "IndexUtil.h"
+#include "Async/ParallelFor.h"
+
+
+void RTGUtils::ComputeTriangleNormals(
+	const FDynamicMesh3& Mesh,
+	TArray<FVector3d>& NormalsOut)
+{
+	NormalsOut.SetNumUninitialized(Mesh.MaxTriangleID());
+	ParallelFor(Mesh.MaxTriangleID(), [&](int32 tid)
+	{
+		NormalsOut[tid] = (Mesh.IsTriangle(tid)) ? Mesh.GetTriNormal(tid) : FVector3d::Zero();
+	});
+}
+
+
+void RTGUtils::ComputeVertexNormals(
+	const FDynamicMesh3& Mesh,
+	TArray<FVector3d>& NormalsOut,
+	bool bWeightByArea,
+	bool bWeightByAngle)
+{
+	// weighted triangle normals and triangle angles
+	TArray<FVector3d> TriNormals, TriAngles;
+	TriNormals.SetNumUninitialized(Mesh.MaxTriangleID());
+	if (bWeightByAngle)
+	{
+		TriAngles.SetNumUninitialized(Mesh.MaxTriangleID());
+	}
+	ParallelFor(Mesh.MaxTriangleID(), [&](int32 tid)
+	{
+		if (Mesh.IsTriangle(tid) == false)
+		{
+			return;
+		}
+		FVector3d A, B, C;
+		Mesh.GetTriVertices(tid, A, B, C);
+		FVector3d AreaNormal = (B - A).Cross(C - A);		// length is twice the area
+		TriNormals[tid] = (bWeightByArea) ? AreaNormal : AreaNormal.Normalized();
+		if (bWeightByAngle)
+		{
+			TriAngles[tid] = FVector3d(
+				(B - A).Normalized().AngleR((C - A).Normalized()),
+				(C - B).Normalized().AngleR((A - B).Normalized()),
+				(A - C).Normalized().AngleR((B - C).Normalized()));
+		}
+	});
+
+	// gather over the one-ring of each vertex
+	NormalsOut.SetNumUninitialized(Mesh.MaxVertexID());
+	ParallelFor(Mesh.MaxVertexID(), [&](int32 vid)
+	{
+		FVector3d Normal = FVector3d::Zero();
+		if (Mesh.IsVertex(vid))
+		{
+			for (int32 tid : Mesh.VtxTrianglesItr(vid))
+			{
+				if (bWeightByAngle)
+				{
+					int32 j = IndexUtil::FindTriIndex(vid, Mesh.GetTriangle(tid));
+					Normal += TriAngles[tid][j] * TriNormals[tid];
+				}
+				else
+				{
+					Normal += TriNormals[tid];
+				}
+			}
+			Normal.Normalize();
+		}
+		NormalsOut[vid] = Normal;
+	});
+}
+
+
+void RTGUtils::InitializeOverlayToPerVertexNormals(FDynamicMeshNormalOverlay* NormalOverlay)
+{
+	const FDynamicMesh3& Mesh = *NormalOverlay->GetParentMesh();
+	TArray<FVector3d> Normals;
+	ComputeVertexNormals(Mesh, Normals);
+
+	// element creation modifies shared overlay data structures, so it is done serially
+	NormalOverlay->ClearElements();
+	TArray<int32> VertexToElement;
+	VertexToElement.SetNumUninitialized(Mesh.MaxVertexID());
+	for (int32 vid : Mesh.VertexIndicesItr())
+	{
+		VertexToElement[vid] = NormalOverlay->AppendElement((FVector3f)Normals[vid]);
+	}
+	for (int32 tid : Mesh.TriangleIndicesItr())
+	{
+		FIndex3i Tri = Mesh.GetTriangle(tid);
+		NormalOverlay->SetTriangle(tid, FIndex3i(VertexToElement[Tri.A], VertexToElement[Tri.B], VertexToElement[Tri.C]));
+	}
+}
+
+
+void RTGUtils::InitializeOverlayToPerTriangleNormals(FDynamicMeshNormalOverlay* NormalOverlay)
+{
+	const FDynamicMesh3& Mesh = *NormalOverlay->GetParentMesh();
+	TArray<FVector3d> Normals;
+	ComputeTriangleNormals(Mesh, Normals);
+
+	NormalOverlay->ClearElements();
+	for (int32 tid : Mesh.TriangleIndicesItr())
+	{
+		int32 ElemID = NormalOverlay->AppendElement((FVector3f)Normals[tid]);
+		NormalOverlay->SetTriangle(tid, FIndex3i(ElemID, ElemID, ElemID));
+	}
+}
@@ -0,0 +1,420 @@
+#include "MeshPatchRuntimeUtils.h"
+
+#include "DynamicSubmesh3.h"
+#include "DynamicMeshEditor.h"
+#include "MeshConstraintsUtil.h"
+#include "MeshSimplification.h"
+#include "QueueRemesher.h"
+#include "Async/ParallelFor.h"
+
+#include "MeshNormalsRuntimeUtils.h"
+
+
+
+void RTGUtils::PartitionMeshSpatially(
+	const FDynamicMesh3& Mesh,
+	int32 CellsPerAxis,
+	TArray<TArray<int32>>& PatchesOut,
+	double CellShift)
+{
+	CellsPerAxis = FMath::Max(1, CellsPerAxis);
+	CellShift = FMathd::Clamp(CellShift, 0.0, 1.0);
+	// a shifted grid needs one more cell per axis to cover the bounds
+	int32 NumCells = (CellShift > 0) ? (CellsPerAxis + 1) : CellsPerAxis;
+	FAxisAlignedBox3d Bounds = Mesh.GetBounds();
+	FVector3d CellSize;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		CellSize[j] = FMathd::Max((Bounds.Max[j] - Bounds.Min[j]) / (double)CellsPerAxis, FMathf::ZeroTolerance);
+	}
+
+	TArray<TArray<int32>> Cells;
+	Cells.SetNum(NumCells * NumCells * NumCells);
+	for (int32 tid : Mesh.TriangleIndicesItr())
+	{
+		FVector3d Centroid = Mesh.GetTriCentroid(tid);
+		int32 CellIndex[3];
+		for (int32 j = 0; j < 3; ++j)
+		{
+			CellIndex[j] = FMath::Clamp((int32)((Centroid[j] - Bounds.Min[j]) / CellSize[j] + CellShift), 0, NumCells - 1);
+		}
+		Cells[CellIndex[0] + NumCells * (CellIndex[1] + NumCells * CellIndex[2])].Add(tid);
+	}
+
+	for (TArray<int32>& Cell : Cells)
+	{
+		if (Cell.Num() > 0)
+		{
+			PatchesOut.Add(MoveTemp(Cell));
+		}
+	}
+}
+
+
+
+bool RTGUtils::ProcessMeshPatchesInParallel(
+	FDynamicMesh3& Mesh,
+	const TArray<TArray<int32>>& Patches,
+	TFunctionRef<void(int32, FDynamicMesh3&)> ProcessFunc,
+	TArray<int32>* NewTrianglesOut,
+	TArray<int32>* BorderVerticesOut)
+{
+	int32 NumPatches = Patches.Num();
+	TArray<FDynamicMesh3> PatchMeshes;
+	PatchMeshes.SetNum(NumPatches);
+	// for each patch, the submesh and base mesh vertex IDs of its border edges, as (SubA, SubB, BaseA, BaseB)
+	TArray<TArray<FIndex4i>> PatchBorderEdges;
+	PatchBorderEdges.SetNum(NumPatches);
+	ParallelFor(NumPatches, [&](int32 k)
+	{
+		FDynamicSubmesh3 Submesh(&Mesh, Patches[k]);
+		PatchMeshes[k] = Submesh.GetSubmesh();
+		const FDynamicMesh3& PatchMesh = PatchMeshes[k];
+		for (int32 eid : PatchMesh.BoundaryEdgeIndicesItr())
+		{
+			FIndex2i EdgeV = PatchMesh.GetEdgeV(eid);
+			PatchBorderEdges[k].Add(FIndex4i(EdgeV.A, EdgeV.B, Submesh.MapVertexToBaseMesh(EdgeV.A), Submesh.MapVertexToBaseMesh(EdgeV.B)));
+		}
+		ProcessFunc(k, PatchMeshes[k]);
+	});
+
+	FDynamicMeshEditor Editor(&Mesh);
+	for (const TArray<int32>& Patch : Patches)
+	{
+		Editor.RemoveTriangles(Patch, true);
+	}
+
+	// Each border edge of the base mesh now has up to two copies, in two different patches or in a patch and the rest of Mesh,
+	// identified by the base mesh vertices of the edge. The base mesh edges still exist if they are used by triangles outside
+	// the patches, find them first because removed vertex IDs can be reused by AppendMesh.
+	auto BaseEdgeKey = [](int32 BaseA, int32 BaseB) { return ((uint64)(uint32)FMath::Min(BaseA, BaseB) << 32) | (uint64)(uint32)FMath::Max(BaseA, BaseB); };
+	TMap<uint64, FIndex2i> BorderEdgeCopies;
+	auto AddBorderEdgeCopy = [&BorderEdgeCopies](uint64 Key, int32 eid)
+	{
+		FIndex2i& Copies = BorderEdgeCopies.FindOrAdd(Key, FIndex2i::Invalid());
+		if (Copies.A == FDynamicMesh3::InvalidID)
+		{
+			Copies.A = eid;
+		}
+		else if (Copies.A != eid)
+		{
+			Copies.B = eid;
+		}
+	};
+	for (const TArray<FIndex4i>& BorderEdges : PatchBorderEdges)
+	{
+		for (const FIndex4i& BorderEdge : BorderEdges)
+		{
+			int32 BaseEdgeID = Mesh.FindEdge(BorderEdge.C, BorderEdge.D);
+			if (BaseEdgeID != FDynamicMesh3::InvalidID)
+			{
+				AddBorderEdgeCopy(BaseEdgeKey(BorderEdge.C, BorderEdge.D), BaseEdgeID);
+			}
+		}
+	}
+
+	for (int32 k = 0; k < NumPatches; ++k)
+	{
+		const FDynamicMesh3& PatchMesh = PatchMeshes[k];
+		FMeshIndexMappings Mappings;
+		Editor.AppendMesh(&PatchMesh, Mappings);
+		if (NewTrianglesOut != nullptr)
+		{
+			for (int32 tid : PatchMesh.TriangleIndicesItr())
+			{
+				NewTrianglesOut->Add(Mappings.GetNewTriangle(tid));
+			}
+		}
+		for (const FIndex4i& BorderEdge : PatchBorderEdges[k])
+		{
+			int32 NewEdgeID = Mesh.FindEdge(Mappings.GetNewVertex(BorderEdge.A), Mappings.GetNewVertex(BorderEdge.B));
+			if (ensure(NewEdgeID != FDynamicMesh3::InvalidID))
+			{
+				AddBorderEdgeCopy(BaseEdgeKey(BorderEdge.C, BorderEdge.D), NewEdgeID);
+			}
+		}
+	}
+
+	// Weld the pairs of copies, keeping the base mesh edge if there is one. The patch borders were not modified, so the copies
+	// are coincident. Merging an edge can also merge an adjacent pair, in that case that pair is no longer two boundary edges.
+	// A failed merge leaves a crack along that edge, which is reported to the caller.
+	bool bAllMerged = true;
+	for (const TPair<uint64, FIndex2i>& Copies : BorderEdgeCopies)
+	{
+		int32 KeepEdgeID = Copies.Value.A, DiscardEdgeID = Copies.Value.B;
+		if (DiscardEdgeID != FDynamicMesh3::InvalidID
+			&& Mesh.IsEdge(KeepEdgeID) && Mesh.IsBoundaryEdge(KeepEdgeID)
+			&& Mesh.IsEdge(DiscardEdgeID) && Mesh.IsBoundaryEdge(DiscardEdgeID))
+		{
+			FDynamicMesh3::FMergeEdgesInfo MergeInfo;
+			if (Mesh.MergeEdges(KeepEdgeID, DiscardEdgeID, MergeInfo) != EMeshResult::Ok)
+			{
+				bAllMerged = false;
+			}
+		}
+	}
+
+	if (BorderVerticesOut != nullptr)
+	{
+		TSet<int32> BorderVertexSet;
+		for (const TPair<uint64, FIndex2i>& Copies : BorderEdgeCopies)
+		{
+			for (int32 j = 0; j < 2; ++j)
+			{
+				if (Mesh.IsEdge(Copies.Value[j]))
+				{
+					FIndex2i EdgeV = Mesh.GetEdgeV(Copies.Value[j]);
+					for (int32 i = 0; i < 2; ++i)
+					{
+						if (BorderVertexSet.Contains(EdgeV[i]) == false)
+						{
+							BorderVertexSet.Add(EdgeV[i]);
+							BorderVerticesOut->Add(EdgeV[i]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return bAllMerged;
+}
+
+
+
+FMeshConstraints RTGUtils::MakePatchBoundaryConstraints(const FDynamicMesh3& PatchMesh)
+{
+	FMeshConstraints Constraints;
+	FMeshConstraintsUtil::ConstrainAllBoundariesAndSeams(Constraints, PatchMesh,
+		EEdgeRefineFlags::FullyConstrained, EEdgeRefineFlags::NoConstraint, EEdgeRefineFlags::NoConstraint,
+		false, false, false);
+	return Constraints;
+}
+
+
+
+bool RTGUtils::ParallelSimplifyToTriangleCount(
+	FDynamicMesh3& Mesh,
+	int32 TargetTriangleCount,
+	int32 PatchesPerAxis)
+{
+	TargetTriangleCount = FMath::Max(1, TargetTriangleCount);
+	if (TargetTriangleCount >= Mesh.TriangleCount())
+	{
+		return true;
+	}
+
+	TArray<TArray<int32>> Patches;
+	PartitionMeshSpatially(Mesh, PatchesPerAxis, Patches);
+	bool bWeldedOK = true;
+	if (Patches.Num() > 1)
+	{
+		// leave some slack in each patch for the final pass
+		const double PatchSlack = 1.1;
+		double KeepFraction = FMathd::Min(1.0, PatchSlack * (double)TargetTriangleCount / (double)Mesh.TriangleCount());
+		bWeldedOK = ProcessMeshPatchesInParallel(Mesh, Patches, [KeepFraction](int32 PatchIndex, FDynamicMesh3& PatchMesh)
+		{
+			FQEMSimplification Simplifier(&PatchMesh);
+			Simplifier.SetExternalConstraints(MakePatchBoundaryConstraints(PatchMesh));
+			Simplifier.SimplifyToTriangleCount(FMath::Max(1, (int32)(KeepFraction * (double)PatchMesh.TriangleCount())));
+		});
+		Mesh.CompactInPlace();
+	}
+
+	// relaxed pass, the patch borders are now regular interior edges
+	FQEMSimplification Simplifier(&Mesh);
+	Simplifier.SimplifyToTriangleCount(TargetTriangleCount);
+	return bWeldedOK;
+}
+
+
+
+void RTGUtils::ParallelSmoothVertices(
+	FDynamicMesh3& Mesh,
+	double Alpha,
+	int32 Iterations,
+	const TArray<int32>* Vertices)
+{
+	Alpha = FMathd::Clamp(Alpha, 0.0, 1.0);
+	int32 NumVertices = (Vertices != nullptr) ? Vertices->Num() : Mesh.MaxVertexID();
+	auto GetVertexID = [Vertices](int32 Index) { return (Vertices != nullptr) ? (*Vertices)[Index] : Index; };
+
+	TArray<FVector3d> Normals;
+	TArray<FVector3d> NewPositions;
+	NewPositions.SetNumUninitialized(Mesh.MaxVertexID());
+	for (int32 k = 0; k < Iterations; ++k)
+	{
+		ComputeVertexNormals(Mesh, Normals);
+
+		ParallelFor(NumVertices, [&](int32 Index)
+		{
+			int32 vid = GetVertexID(Index);
+			if (Mesh.IsVertex(vid) == false)
+			{
+				return;
+			}
+			FVector3d Pos = Mesh.GetVertex(vid);
+			NewPositions[vid] = Pos;
+			if (Mesh.IsBoundaryVertex(vid))
+			{
+				return;
+			}
+
+			FVector3d Centroid = FVector3d::Zero();
+			int32 NumNeighbours = 0;
+			for (int32 nbrvid : Mesh.VtxVerticesItr(vid))
+			{
+				Centroid += Mesh.GetVertex(nbrvid);
+				NumNeighbours++;
+			}
+			if (NumNeighbours > 0)
+			{
+				FVector3d Delta = Centroid / (double)NumNeighbours - Pos;
+				Delta -= Delta.Dot(Normals[vid]) * Normals[vid];
+				NewPositions[vid] = Pos + Alpha * Delta;
+			}
+		});
+
+		ParallelFor(NumVertices, [&](int32 Index)
+		{
+			int32 vid = GetVertexID(Index);
+			if (Mesh.IsVertex(vid))
+			{
+				Mesh.SetVertex(vid, NewPositions[vid]);
+			}
+		});
+	}
+}
+
+
+
+/**
+ * Find the vertices within NumRings one-rings of Vertices, including Vertices
+ */
+static void ExpandVertexRings(const FDynamicMesh3& Mesh, const TArray<int32>& Vertices, int32 NumRings, TArray<int32>& VerticesOut)
+{
+	TArray<bool> InSet;
+	InSet.Init(false, Mesh.MaxVertexID());
+	for (int32 vid : Vertices)
+	{
+		if (Mesh.IsVertex(vid) && InSet[vid] == false)
+		{
+			InSet[vid] = true;
+			VerticesOut.Add(vid);
+		}
+	}
+	int32 FrontStart = 0;
+	for (int32 Ring = 0; Ring < NumRings; ++Ring)
+	{
+		int32 FrontEnd = VerticesOut.Num();
+		for (int32 k = FrontStart; k < FrontEnd; ++k)
+		{
+			for (int32 nbrvid : Mesh.VtxVerticesItr(VerticesOut[k]))
+			{
+				if (InSet[nbrvid] == false)
+				{
+					InSet[nbrvid] = true;
+					VerticesOut.Add(nbrvid);
+				}
+			}
+		}
+		FrontStart = FrontEnd;
+	}
+}
+
+
+static void RemeshPatchWithLockedBorder(FDynamicMesh3& PatchMesh, double TargetEdgeLength, double SmoothSpeedT)
+{
+	FQueueRemesher Remesher(&PatchMesh);
+	Remesher.SetExternalConstraints(RTGUtils::MakePatchBoundaryConstraints(PatchMesh));
+	Remesher.SetTargetEdgeLength(TargetEdgeLength);
+	Remesher.SmoothSpeedT = SmoothSpeedT;
+	Remesher.FastestRemesh();
+}
+
+
+bool RTGUtils::ParallelRemesh(
+	FDynamicMesh3& Mesh,
+	double TargetEdgeLength,
+	double SmoothSpeedT,
+	int32 PatchesPerAxis)
+{
+	auto RemeshPatch = [TargetEdgeLength, SmoothSpeedT](int32 PatchIndex, FDynamicMesh3& PatchMesh)
+	{
+		RemeshPatchWithLockedBorder(PatchMesh, TargetEdgeLength, SmoothSpeedT);
+	};
+
+	// first pass remeshes everything except the strips along the patch borders, the second pass remeshes those strips
+	// because the shifted patches contain them in their interior
+	TArray<TArray<int32>> Patches;
+	PartitionMeshSpatially(Mesh, PatchesPerAxis, Patches, 0.0);
+	bool bWeldedOK = ProcessMeshPatchesInParallel(Mesh, Patches, RemeshPatch);
+	Mesh.CompactInPlace();
+
+	Patches.Reset();
+	TArray<int32> BorderVertices;
+	PartitionMeshSpatially(Mesh, PatchesPerAxis, Patches, 0.5);
+	bWeldedOK = ProcessMeshPatchesInParallel(Mesh, Patches, RemeshPatch, nullptr, &BorderVertices) && bWeldedOK;
+
+	// the remaining seams are where the borders of the second pass cross the borders of the first pass, so only the vertices near
+	// the borders of the second pass have to be relaxed
+	TArray<int32> SeamVertices;
+	ExpandVertexRings(Mesh, BorderVertices, 2, SeamVertices);
+	ParallelSmoothVertices(Mesh, SmoothSpeedT, 2, &SeamVertices);
+	Mesh.CompactInPlace();
+	return bWeldedOK;
+}
+
+
+
+bool RTGUtils::RemeshRegion(
+	FDynamicMesh3& Mesh,
+	const TArray<int32>& Triangles,
+	double TargetEdgeLength,
+	int32 ExpandRings,
+	double SmoothSpeedT,
+	TArray<int32>* RegionTrianglesOut)
+{
+	// grow the region by one-rings of the vertices of the current front, so only the region and its border are visited
+	TSet<int32> RegionSet;
+	TArray<int32> Front;
+	for (int32 tid : Triangles)
+	{
+		if (Mesh.IsTriangle(tid) && RegionSet.Contains(tid) == false)
+		{
+			RegionSet.Add(tid);
+			Front.Add(tid);
+		}
+	}
+	for (int32 Ring = 0; Ring < ExpandRings && Front.Num() > 0; ++Ring)
+	{
+		TArray<int32> NextFront;
+		for (int32 tid : Front)
+		{
+			FIndex3i Tri = Mesh.GetTriangle(tid);
+			for (int32 j = 0; j < 3; ++j)
+			{
+				for (int32 nbrtid : Mesh.VtxTrianglesItr(Tri[j]))
+				{
+					if (RegionSet.Contains(nbrtid) == false)
+					{
+						RegionSet.Add(nbrtid);
+						NextFront.Add(nbrtid);
+					}
+				}
+			}
+		}
+		Front = MoveTemp(NextFront);
+	}
+	if (RegionSet.Num() == 0)
+	{
+		return true;
+	}
+
+	TArray<TArray<int32>> Patches;
+	Patches.Add(RegionSet.Array());
+	return ProcessMeshPatchesInParallel(Mesh, Patches, [TargetEdgeLength, SmoothSpeedT](int32 PatchIndex, FDynamicMesh3& PatchMesh)
+	{
+		RemeshPatchWithLockedBorder(PatchMesh, TargetEdgeLength, SmoothSpeedT);
+	}, RegionTrianglesOut);
+}
@@ -0,0 +1,408 @@
+#include "MeshUVRuntimeUtils.h"
+
+#include "DynamicMeshAttributeSet.h"
+#include "FrameTypes.h"
+#include "BoxTypes.h"
+#include "MeshNormalsRuntimeUtils.h"
+#include "Async/ParallelFor.h"
+
+// UnrealMathUtility.h #defines PI and Eigen doesn't like this
+#ifdef PI
+#undef PI
+#endif
+
+THIRD_PARTY_INCLUDES_START
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+THIRD_PARTY_INCLUDES_END
+
+
+void RTGUtils::ComputeUVCharts(
+	const FDynamicMesh3& Mesh,
+	double MaxNormalDeviationDeg,
+	TArray<TArray<int32>>& ChartsOut)
+{
+	ChartsOut.Reset();
+
+	TArray<FVector3d> TriNormals;
+	ComputeTriangleNormals(Mesh, TriNormals);
+	TArray<double> TriAreas;
+	TriAreas.SetNumUninitialized(Mesh.MaxTriangleID());
+	ParallelFor(Mesh.MaxTriangleID(), [&](int32 tid)
+	{
+		TriAreas[tid] = (Mesh.IsTriangle(tid)) ? Mesh.GetTriArea(tid) : 0.0;
+	});
+
+	double MinCos = FMathd::Cos(FMathd::Clamp(MaxNormalDeviationDeg, 1.0, 89.0) * FMathd::DegToRad);
+
+	TArray<int32> TriChart;
+	TriChart.Init(-1, Mesh.MaxTriangleID());
+	TArray<int32> Queue;
+	for (int32 SeedTID : Mesh.TriangleIndicesItr())
+	{
+		if (TriChart[SeedTID] >= 0)
+		{
+			continue;
+		}
+
+		int32 ChartIndex = ChartsOut.Num();
+		TArray<int32>& Chart = ChartsOut.Emplace_GetRef();
+		FVector3d NormalSum = TriAreas[SeedTID] * TriNormals[SeedTID];
+		FVector3d ChartNormal = TriNormals[SeedTID];
+		TriChart[SeedTID] = ChartIndex;
+		Chart.Add(SeedTID);
+
+		// breadth-first growth, so the chart stays compact around the seed
+		Queue.Reset();
+		Queue.Add(SeedTID);
+		for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+		{
+			FIndex3i NbrTris = Mesh.GetTriNeighbourTris(Queue[QueueIndex]);
+			for (int32 j = 0; j < 3; ++j)
+			{
+				int32 NbrTID = NbrTris[j];
+				if (NbrTID != FDynamicMesh3::InvalidID && TriChart[NbrTID] < 0 && TriNormals[NbrTID].Dot(ChartNormal) >= MinCos)
+				{
+					TriChart[NbrTID] = ChartIndex;
+					Chart.Add(NbrTID);
+					Queue.Add(NbrTID);
+					NormalSum += TriAreas[NbrTID] * TriNormals[NbrTID];
+					double Length = NormalSum.Length();
+					if (Length > FMathd::ZeroTolerance)
+					{
+						ChartNormal = NormalSum / Length;
+					}
+				}
+			}
+		}
+	}
+}
+
+
+bool RTGUtils::ComputeConformalChartUVs(
+	const FDynamicMesh3& Mesh,
+	const TArray<int32>& ChartTriangles,
+	TArray<int32>& ChartVerticesOut,
+	TArray<FVector2d>& UVsOut)
+{
+	ChartVerticesOut.Reset();
+	UVsOut.Reset();
+
+	// chart-local vertex indices, and the number of chart triangles using each edge (boundary edges are used once)
+	TMap<int32, int32> VertexIndex;
+	TMap<int32, int32> EdgeUseCount;
+	TArray<FIndex3i> LocalTriangles;
+	LocalTriangles.Reserve(ChartTriangles.Num());
+	for (int32 tid : ChartTriangles)
+	{
+		FIndex3i Tri = Mesh.GetTriangle(tid);
+		FIndex3i LocalTri;
+		for (int32 j = 0; j < 3; ++j)
+		{
+			int32* Found = VertexIndex.Find(Tri[j]);
+			if (Found == nullptr)
+			{
+				Found = &VertexIndex.Add(Tri[j], ChartVerticesOut.Num());
+				ChartVerticesOut.Add(Tri[j]);
+			}
+			LocalTri[j] = *Found;
+		}
+		LocalTriangles.Add(LocalTri);
+		FIndex3i TriEdges = Mesh.GetTriEdges(tid);
+		for (int32 j = 0; j < 3; ++j)
+		{
+			EdgeUseCount.FindOrAdd(TriEdges[j])++;
+		}
+	}
+	int32 NumVertices = ChartVerticesOut.Num();
+	if (NumVertices < 3)
+	{
+		return false;
+	}
+
+	TArray<FVector3d> Positions;
+	Positions.SetNumUninitialized(NumVertices);
+	for (int32 k = 0; k < NumVertices; ++k)
+	{
+		Positions[k] = Mesh.GetVertex(ChartVerticesOut[k]);
+	}
+
+	// LSCM energy is E_D(u,v) - A(u,v), the Dirichlet energy minus the signed area of the UV chart, which is zero only for conformal maps.
+	// With x = [u; v] it is 1/2 x^T H x, where H = diag(K, K) - (area terms), and K is the (positive semi-definite) cotangent Laplacian.
+	std::vector<Eigen::Triplet<double>> Entries;
+	Entries.reserve(24 * LocalTriangles.Num());
+	TArray<FIndex2i> BoundaryEdges;
+	for (int32 k = 0; k < LocalTriangles.Num(); ++k)
+	{
+		const FIndex3i& Tri = LocalTriangles[k];
+		FVector3d AreaNormal = (Positions[Tri.B] - Positions[Tri.A]).Cross(Positions[Tri.C] - Positions[Tri.A]);
+		double DoubleArea = AreaNormal.Length();
+		FIndex3i TriEdges = Mesh.GetTriEdges(ChartTriangles[k]);
+		for (int32 j = 0; j < 3; ++j)
+		{
+			int32 V1 = Tri[(j + 1) % 3], V2 = Tri[(j + 2) % 3];
+			if (DoubleArea > FMathd::ZeroTolerance)
+			{
+				// cotangent of the angle at corner j, which is opposite to the edge (j+1, j+2)
+				double Weight = 0.5 * (Positions[V1] - Positions[Tri[j]]).Dot(Positions[V2] - Positions[Tri[j]]) / DoubleArea;
+				for (int32 Offset = 0; Offset <= NumVertices; Offset += NumVertices)
+				{
+					Entries.emplace_back(Offset + V1, Offset + V2, -Weight);
+					Entries.emplace_back(Offset + V2, Offset + V1, -Weight);
+					Entries.emplace_back(Offset + V1, Offset + V1, Weight);
+					Entries.emplace_back(Offset + V2, Offset + V2, Weight);
+				}
+			}
+
+			// edge j is (j, j+1), oriented consistently with the triangle
+			if (EdgeUseCount[TriEdges[j]] == 1)
+			{
+				int32 I = Tri[j], J = Tri[(j + 1) % 3];
+				BoundaryEdges.Add(FIndex2i(I, J));
+				// signed area is 1/2 * sum over boundary edges of (u_i v_j - u_j v_i)
+				Entries.emplace_back(I, NumVertices + J, -0.5);
+				Entries.emplace_back(NumVertices + J, I, -0.5);
+				Entries.emplace_back(J, NumVertices + I, 0.5);
+				Entries.emplace_back(NumVertices + I, J, 0.5);
+			}
+		}
+	}
+	if (BoundaryEdges.Num() == 0)
+	{
+		return false;
+	}
+
+	// pin two distant boundary vertices, which fixes the translation, rotation and scale of the map
+	auto FindFarthestBoundaryVertex = [&](int32 FromVertex)
+	{
+		int32 Farthest = FromVertex;
+		double MaxDistSqr = -1;
+		for (const FIndex2i& Edge : BoundaryEdges)
+		{
+			double DistSqr = Positions[Edge.A].DistanceSquared(Positions[FromVertex]);
+			if (DistSqr > MaxDistSqr)
+			{
+				MaxDistSqr = DistSqr;
+				Farthest = Edge.A;
+			}
+		}
+		return Farthest;
+	};
+	int32 Pin0 = FindFarthestBoundaryVertex(BoundaryEdges[0].A);
+	int32 Pin1 = FindFarthestBoundaryVertex(Pin0);
+	double PinDistance = Positions[Pin0].Distance(Positions[Pin1]);
+	if (Pin0 == Pin1 || PinDistance < FMathd::ZeroTolerance)
+	{
+		return false;
+	}
+
+	// index of each of the 2N unknowns in the free block, or -1 for pinned unknowns
+	TArray<int32> FreeIndex;
+	FreeIndex.SetNumUninitialized(2 * NumVertices);
+	Eigen::VectorXd PinnedValues = Eigen::VectorXd::Zero(2 * NumVertices);
+	PinnedValues[Pin1] = PinDistance;
+	int32 NumFree = 0;
+	for (int32 k = 0; k < 2 * NumVertices; ++k)
+	{
+		int32 Vertex = k % NumVertices;
+		FreeIndex[k] = (Vertex == Pin0 || Vertex == Pin1) ? -1 : NumFree++;
+	}
+
+	// split H into the free block and the right-hand side from the pinned values
+	std::vector<Eigen::Triplet<double>> FreeEntries;
+	FreeEntries.reserve(Entries.size());
+	Eigen::VectorXd RHS = Eigen::VectorXd::Zero(NumFree);
+	for (const Eigen::Triplet<double>& Entry : Entries)
+	{
+		int32 Row = FreeIndex[Entry.row()], Col = FreeIndex[Entry.col()];
+		if (Row >= 0 && Col >= 0)
+		{
+			FreeEntries.emplace_back(Row, Col, Entry.value());
+		}
+		else if (Row >= 0)
+		{
+			RHS[Row] -= Entry.value() * PinnedValues[Entry.col()];
+		}
+	}
+	Eigen::SparseMatrix<double> FreeMatrix(NumFree, NumFree);
+	FreeMatrix.setFromTriplets(FreeEntries.begin(), FreeEntries.end());
+
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> Solver(FreeMatrix);
+	if (Solver.info() != Eigen::Success)
+	{
+		return false;
+	}
+	Eigen::VectorXd FreeValues = Solver.solve(RHS);
+	if (Solver.info() != Eigen::Success || FreeValues.allFinite() == false)
+	{
+		return false;
+	}
+
+	UVsOut.SetNumUninitialized(NumVertices);
+	for (int32 k = 0; k < NumVertices; ++k)
+	{
+		int32 UIndex = FreeIndex[k], VIndex = FreeIndex[NumVertices + k];
+		UVsOut[k] = FVector2d(
+			(UIndex >= 0) ? FreeValues[UIndex] : PinnedValues[k],
+			(VIndex >= 0) ? FreeValues[VIndex] : PinnedValues[NumVertices + k]);
+	}
+	return true;
+}
+
+
+void RTGUtils::PackUVCharts(
+	TArray<TArray<FVector2d>>& ChartUVs,
+	double Gutter)
+{
+	int32 NumCharts = ChartUVs.Num();
+
+	// move each chart to the origin, rotated so that it is wider than it is tall
+	TArray<FVector2d> ChartSizes;
+	ChartSizes.SetNumUninitialized(NumCharts);
+	ParallelFor(NumCharts, [&](int32 ChartIndex)
+	{
+		TArray<FVector2d>& UVs = ChartUVs[ChartIndex];
+		FAxisAlignedBox2d Bounds = FAxisAlignedBox2d::Empty();
+		for (const FVector2d& UV : UVs)
+		{
+			Bounds.Contain(UV);
+		}
+		bool bRotate = Bounds.Height() > Bounds.Width();
+		for (FVector2d& UV : UVs)
+		{
+			FVector2d Local = UV - Bounds.Min;
+			UV = (bRotate) ? FVector2d(Local.Y, Bounds.Width() - Local.X) : Local;
+		}
+		ChartSizes[ChartIndex] = (UVs.Num() == 0) ? FVector2d::Zero() :
+			((bRotate) ? FVector2d(Bounds.Height(), Bounds.Width()) : FVector2d(Bounds.Width(), Bounds.Height()));
+	});
+
+	// the gutter is specified relative to the packed size, which is estimated from the total chart area
+	double TotalArea = 0, MaxWidth = 0;
+	for (const FVector2d& Size : ChartSizes)
+	{
+		TotalArea += Size.X * Size.Y;
+		MaxWidth = FMathd::Max(MaxWidth, Size.X);
+	}
+	double ChartGutter = Gutter * FMathd::Sqrt(TotalArea);
+
+	// shelf packing, tallest charts first
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumCharts);
+	for (int32 k = 0; k < NumCharts; ++k)
+	{
+		Order[k] = k;
+	}
+	Order.Sort([&](int32 A, int32 B) { return ChartSizes[A].Y > ChartSizes[B].Y; });
+
+	double ShelfWidth = FMathd::Max(FMathd::Sqrt(TotalArea) * 1.1, MaxWidth) + ChartGutter;
+	TArray<FVector2d> ChartOffsets;
+	ChartOffsets.SetNumUninitialized(NumCharts);
+	double ShelfX = ChartGutter, ShelfY = ChartGutter, ShelfHeight = 0, PackedWidth = 0;
+	for (int32 ChartIndex : Order)
+	{
+		const FVector2d& Size = ChartSizes[ChartIndex];
+		if (ShelfX + Size.X + ChartGutter > ShelfWidth && ShelfX > ChartGutter)
+		{
+			ShelfY += ShelfHeight + ChartGutter;
+			ShelfX = ChartGutter;
+			ShelfHeight = 0;
+		}
+		ChartOffsets[ChartIndex] = FVector2d(ShelfX, ShelfY);
+		ShelfX += Size.X + ChartGutter;
+		ShelfHeight = FMathd::Max(ShelfHeight, Size.Y);
+		PackedWidth = FMathd::Max(PackedWidth, ShelfX);
+	}
+	double PackedHeight = ShelfY + ShelfHeight + ChartGutter;
+
+	// uniform scale into the unit square
+	double PackedSize = FMathd::Max(PackedWidth, PackedHeight);
+	double Scale = (PackedSize > FMathd::ZeroTolerance) ? (1.0 / PackedSize) : 1.0;
+	ParallelFor(NumCharts, [&](int32 ChartIndex)
+	{
+		for (FVector2d& UV : ChartUVs[ChartIndex])
+		{
+			UV = (UV + ChartOffsets[ChartIndex]) * Scale;
+		}
+	});
+}
+
+
+void RTGUtils::ComputeChartUVs(
+	FDynamicMesh3& Mesh,
+	double MaxNormalDeviationDeg,
+	double Gutter)
+{
+	TArray<TArray<int32>> Charts;
+	ComputeUVCharts(Mesh, MaxNormalDeviationDeg, Charts);
+	int32 NumCharts = Charts.Num();
+
+	TArray<TArray<int32>> ChartVertices;
+	TArray<TArray<FVector2d>> ChartUVs;
+	ChartVertices.SetNum(NumCharts);
+	ChartUVs.SetNum(NumCharts);
+	// charts are independent, and the per-chart sparse systems are small, so solve them in parallel
+	ParallelFor(NumCharts, [&](int32 ChartIndex)
+	{
+		const TArray<int32>& Chart = Charts[ChartIndex];
+		if (ComputeConformalChartUVs(Mesh, Chart, ChartVertices[ChartIndex], ChartUVs[ChartIndex]))
+		{
+			return;
+		}
+
+		// fall back to planar projection
+		FVector3d NormalSum = FVector3d::Zero();
+		for (int32 tid : Chart)
+		{
+			NormalSum += Mesh.GetTriArea(tid) * Mesh.GetTriNormal(tid);
+		}
+		TArray<int32>& Vertices = ChartVertices[ChartIndex];
+		Vertices.Reset();
+		TSet<int32> VertexSet;
+		for (int32 tid : Chart)
+		{
+			FIndex3i Tri = Mesh.GetTriangle(tid);
+			for (int32 j = 0; j < 3; ++j)
+			{
+				bool bAlreadyInSet = false;
+				VertexSet.Add(Tri[j], &bAlreadyInSet);
+				if (bAlreadyInSet == false)
+				{
+					Vertices.Add(Tri[j]);
+				}
+			}
+		}
+		FFrame3d ProjectionFrame(Mesh.GetVertex(Vertices[0]), NormalSum.Normalized());
+		TArray<FVector2d>& UVs = ChartUVs[ChartIndex];
+		UVs.SetNumUninitialized(Vertices.Num());
+		for (int32 k = 0; k < Vertices.Num(); ++k)
+		{
+			UVs[k] = ProjectionFrame.ToPlaneUV(Mesh.GetVertex(Vertices[k]), 2);
+		}
+	});
+
+	PackUVCharts(ChartUVs, Gutter);
+
+	// one UV element per chart vertex, so chart borders become UV seams
+	if (Mesh.HasAttributes() == false)
+	{
+		Mesh.EnableAttributes();
+	}
+	FDynamicMeshUVOverlay* UVOverlay = Mesh.Attributes()->PrimaryUV();
+	UVOverlay->ClearElements();
+	TArray<int32> VertexElements;
+	VertexElements.Init(FDynamicMesh3::InvalidID, Mesh.MaxVertexID());
+	for (int32 ChartIndex = 0; ChartIndex < NumCharts; ++ChartIndex)
+	{
+		const TArray<int32>& Vertices = ChartVertices[ChartIndex];
+		for (int32 k = 0; k < Vertices.Num(); ++k)
+		{
+			VertexElements[Vertices[k]] = UVOverlay->AppendElement(FVector2f(ChartUVs[ChartIndex][k]));
+		}
+		for (int32 tid : Charts[ChartIndex])
+		{
+			FIndex3i Tri = Mesh.GetTriangle(tid);
+			UVOverlay->SetTriangle(tid, FIndex3i(VertexElements[Tri.A], VertexElements[Tri.B], VertexElements[Tri.C]));
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#include "PrimitiveMeshCache.h"
+
+#include "Misc/ScopeLock.h"
+
+
+namespace
+{
+	FCriticalSection PrimitiveTemplatesLock;
+	TMap<RTGUtils::FPrimitiveTemplateKey, TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe>> PrimitiveTemplates;
+}
+
+
+TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe> RTGUtils::FindOrAddPrimitiveTemplate(
+	const FPrimitiveTemplateKey& Key,
+	TFunctionRef<void(FDynamicMesh3&)> GenerateFunc)
+{
+	FScopeLock Lock(&PrimitiveTemplatesLock);
+
+	TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe>* Found = PrimitiveTemplates.Find(Key);
+	if (Found != nullptr)
+	{
+		return *Found;
+	}
+
+	TSharedPtr<FDynamicMesh3, ESPMode::ThreadSafe> NewTemplate = MakeShared<FDynamicMesh3, ESPMode::ThreadSafe>();
+	GenerateFunc(*NewTemplate);
+	PrimitiveTemplates.Add(Key, NewTemplate);
+	return NewTemplate;
+}
+
+
+void RTGUtils::ClearPrimitiveTemplates()
+{
+	FScopeLock Lock(&PrimitiveTemplatesLock);
+	PrimitiveTemplates.Empty();
+}
@@ -0,0 +1,63 @@
+#include "SimplificationLODChain.h"
+
+
+void RTGUtils::FSimplificationLODChain::Build(const FDynamicMesh3& BaseMesh, FSimplifyFunc SimplifyFunc, double LevelRatio, int32 MinTriangleCount)
+{
+	Levels.Reset();
+	TUniquePtr<FDynamicMesh3> Base = MakeUnique<FDynamicMesh3>();
+	Base->CompactCopy(BaseMesh);
+	Levels.Add(MoveTemp(Base));
+
+	LevelRatio = FMathd::Clamp(LevelRatio, 0.1, 0.9);
+	while (true)
+	{
+		const FDynamicMesh3& Previous = *Levels.Last();
+		int32 LevelTriangleCount = (int32)(LevelRatio * (double)Previous.TriangleCount());
+		if (LevelTriangleCount < MinTriangleCount)
+		{
+			break;
+		}
+
+		TUniquePtr<FDynamicMesh3> Level = MakeUnique<FDynamicMesh3>();
+		Level->CompactCopy(Previous);
+		SimplifyFunc(*Level, LevelTriangleCount);
+		// stop if the simplifier could not make progress, eg due to constraints
+		if (Level->TriangleCount() >= Previous.TriangleCount())
+		{
+			break;
+		}
+		Levels.Add(MoveTemp(Level));
+	}
+}
+
+
+int32 RTGUtils::FSimplificationLODChain::GetBaseTriangleCount() const
+{
+	return (Levels.Num() > 0) ? Levels[0]->TriangleCount() : 0;
+}
+
+
+void RTGUtils::FSimplificationLODChain::GetMesh(int32 TargetTriangleCount, FSimplifyFunc SimplifyFunc, FDynamicMesh3& MeshOut) const
+{
+	if (!ensure(IsBuilt()))
+	{
+		return;
+	}
+
+	// coarsest level that still has enough triangles
+	int32 UseLevel = 0;
+	for (int32 k = Levels.Num() - 1; k >= 0; --k)
+	{
+		if (Levels[k]->TriangleCount() >= TargetTriangleCount)
+		{
+			UseLevel = k;
+			break;
+		}
+	}
+
+	MeshOut.CompactCopy(*Levels[UseLevel]);
+	if (MeshOut.TriangleCount() > TargetTriangleCount)
+	{
+		SimplifyFunc(MeshOut, TargetTriangleCount);
+	}
+}
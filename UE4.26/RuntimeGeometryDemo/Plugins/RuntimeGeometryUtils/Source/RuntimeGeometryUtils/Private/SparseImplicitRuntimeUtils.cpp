@@ -0,0 +1,420 @@
+#include "SparseImplicitRuntimeUtils.h"
+#include "MeshFieldRuntimeUtils.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/ThreadSafeBool.h"
+
+
+namespace
+{
+	// Freudenthal decomposition of a cube into 6 tetrahedra around the diagonal from corner 0 to corner 7.
+	// Cube corners are indexed by bits (x = 1, y = 2, z = 4), so each tetrahedron is a monotone path from 0 to 7,
+	// and each tetrahedron edge goes from a corner to one of its 7 positive neighbours.
+	const int32 CubeTetrahedra[6][4] = {
+		{ 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 }, { 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 } };
+
+	// surface extracted from one block, with vertices identified by the global key of their grid edge
+	struct FSparseBlockSurface
+	{
+		TArray<int64> VertexKeys;
+		TArray<FVector3d> Positions;
+		TArray<FIndex3i> Triangles;
+		// bit f is set if the surface crosses block face f, in order -X, +X, -Y, +Y, -Z, +Z
+		uint8 CrossedFaces = 0;
+	};
+}
+
+
+static FVector3i CubeCornerOffset(int32 Corner)
+{
+	return FVector3i(Corner & 1, (Corner >> 1) & 1, (Corner >> 2) & 1);
+}
+
+/** @return true if the tetrahedron (A,B,C,D) of cube corners is positively oriented */
+static bool IsPositiveTetrahedron(int32 A, int32 B, int32 C, int32 D)
+{
+	FVector3i OA = CubeCornerOffset(A);
+	FVector3i U = CubeCornerOffset(B) - OA, V = CubeCornerOffset(C) - OA, W = CubeCornerOffset(D) - OA;
+	int32 Det = U.X * (V.Y * W.Z - V.Z * W.Y) - U.Y * (V.X * W.Z - V.Z * W.X) + U.Z * (V.X * W.Y - V.Y * W.X);
+	return Det > 0;
+}
+
+
+
+/**
+ * Sample Implicit at the corners of the cells of one block and triangulate the cells with marching tetrahedra
+ */
+static void ExtractBlockSurface(
+	TFunctionRef<double(const FVector3d&)> Implicit,
+	const FVector3d& Origin,
+	double CellSize,
+	const FVector3i& NumSamples,
+	const FVector3i& FirstCell,
+	int32 BlockSize,
+	int32 RootRefinementSteps,
+	bool bCloseAtGridBorder,
+	FSparseBlockSurface& SurfaceOut)
+{
+	const int32 N = BlockSize + 1;
+	auto SampleIndex = [N](int32 i, int32 j, int32 k) { return i + N * (j + N * k); };
+	auto GridPosition = [&](const FVector3i& GridIndex) { return Origin + CellSize * FVector3d((double)GridIndex.X, (double)GridIndex.Y, (double)GridIndex.Z); };
+	auto IsBorderSample = [&](const FVector3i& GridIndex)
+	{
+		return bCloseAtGridBorder && (GridIndex.X == 0 || GridIndex.Y == 0 || GridIndex.Z == 0
+			|| GridIndex.X == NumSamples.X - 1 || GridIndex.Y == NumSamples.Y - 1 || GridIndex.Z == NumSamples.Z - 1);
+	};
+
+	TArray<double> Values;
+	Values.SetNumUninitialized(N * N * N);
+	bool FaceHasInside[6] = { false, false, false, false, false, false };
+	bool FaceHasOutside[6] = { false, false, false, false, false, false };
+	for (int32 k = 0; k < N; ++k)
+	{
+		for (int32 j = 0; j < N; ++j)
+		{
+			for (int32 i = 0; i < N; ++i)
+			{
+				FVector3i GridIndex = FirstCell + FVector3i(i, j, k);
+				double Value = Implicit(GridPosition(GridIndex));
+				// the outer layer of the grid is outside, so that the surface is closed
+				if (IsBorderSample(GridIndex))
+				{
+					Value = FMathd::Max(Value, FMathd::ZeroTolerance);
+				}
+				Values[SampleIndex(i, j, k)] = Value;
+
+				bool bInside = (Value < 0);
+				int32 Faces[3] = { (i == 0) ? 0 : ((i == BlockSize) ? 1 : -1), (j == 0) ? 2 : ((j == BlockSize) ? 3 : -1), (k == 0) ? 4 : ((k == BlockSize) ? 5 : -1) };
+				for (int32 Face : Faces)
+				{
+					if (Face >= 0)
+					{
+						FaceHasInside[Face] = FaceHasInside[Face] || bInside;
+						FaceHasOutside[Face] = FaceHasOutside[Face] || !bInside;
+					}
+				}
+			}
+		}
+	}
+	for (int32 Face = 0; Face < 6; ++Face)
+	{
+		if (FaceHasInside[Face] && FaceHasOutside[Face])
+		{
+			SurfaceOut.CrossedFaces |= (1 << Face);
+		}
+	}
+
+	TMap<int64, int32> LocalVertices;
+	auto EdgeVertex = [&](const FVector3i& Cell, int32 CornerA, int32 CornerB)
+	{
+		int32 Lo = FMath::Min(CornerA, CornerB), Hi = FMath::Max(CornerA, CornerB);
+		FVector3i LocalLo = Cell + CubeCornerOffset(Lo), LocalHi = Cell + CubeCornerOffset(Hi);
+		FVector3i GridLo = FirstCell + LocalLo, GridHi = FirstCell + LocalHi;
+		int64 Key = (((int64)GridLo.Z * NumSamples.Y + GridLo.Y) * NumSamples.X + GridLo.X) * 7 + ((Hi ^ Lo) - 1);
+		const int32* Found = LocalVertices.Find(Key);
+		if (Found != nullptr)
+		{
+			return *Found;
+		}
+
+		double ValueLo = Values[SampleIndex(LocalLo.X, LocalLo.Y, LocalLo.Z)];
+		double ValueHi = Values[SampleIndex(LocalHi.X, LocalHi.Y, LocalHi.Z)];
+		FVector3d PosLo = GridPosition(GridLo), PosHi = GridPosition(GridHi);
+		// the sample values on the grid border are overridden, so they cannot be refined
+		if (RootRefinementSteps > 0 && IsBorderSample(GridLo) == false && IsBorderSample(GridHi) == false)
+		{
+			for (int32 Step = 0; Step < RootRefinementSteps; ++Step)
+			{
+				FVector3d Mid = 0.5 * (PosLo + PosHi);
+				double ValueMid = Implicit(Mid);
+				if ((ValueMid < 0) == (ValueLo < 0))
+				{
+					PosLo = Mid;
+					ValueLo = ValueMid;
+				}
+				else
+				{
+					PosHi = Mid;
+					ValueHi = ValueMid;
+				}
+			}
+		}
+		double t = FMathd::Clamp(ValueLo / (ValueLo - ValueHi), 0.0, 1.0);
+
+		int32 NewIndex = SurfaceOut.Positions.Add(PosLo + t * (PosHi - PosLo));
+		SurfaceOut.VertexKeys.Add(Key);
+		LocalVertices.Add(Key, NewIndex);
+		return NewIndex;
+	};
+	auto AddTriangle = [&SurfaceOut](int32 A, int32 B, int32 C)
+	{
+		if (A != B && B != C && C != A)
+		{
+			SurfaceOut.Triangles.Add(FIndex3i(A, B, C));
+		}
+	};
+
+	for (int32 ck = 0; ck < BlockSize; ++ck)
+	{
+		for (int32 cj = 0; cj < BlockSize; ++cj)
+		{
+			for (int32 ci = 0; ci < BlockSize; ++ci)
+			{
+				FVector3i Cell(ci, cj, ck);
+				double CornerValues[8];
+				bool bAnyInside = false, bAnyOutside = false;
+				for (int32 Corner = 0; Corner < 8; ++Corner)
+				{
+					FVector3i Offset = CubeCornerOffset(Corner);
+					CornerValues[Corner] = Values[SampleIndex(ci + Offset.X, cj + Offset.Y, ck + Offset.Z)];
+					bAnyInside = bAnyInside || (CornerValues[Corner] < 0);
+					bAnyOutside = bAnyOutside || (CornerValues[Corner] >= 0);
+				}
+				if (!(bAnyInside && bAnyOutside))
+				{
+					continue;
+				}
+
+				for (int32 Tet = 0; Tet < 6; ++Tet)
+				{
+					int32 Inside[4], Outside[4];
+					int32 NumInside = 0, NumOutside = 0;
+					for (int32 v = 0; v < 4; ++v)
+					{
+						int32 Corner = CubeTetrahedra[Tet][v];
+						if (CornerValues[Corner] < 0)
+						{
+							Inside[NumInside++] = Corner;
+						}
+						else
+						{
+							Outside[NumOutside++] = Corner;
+						}
+					}
+
+					if (NumInside == 1 || NumInside == 3)
+					{
+						// one triangle around the odd corner. Its normal should point away from the inside corners,
+						// triangle (B,C,D) of a positive tetrahedron (A,B,C,D) faces away from A.
+						int32 Apex = (NumInside == 1) ? Inside[0] : Outside[0];
+						const int32* Others = (NumInside == 1) ? Outside : Inside;
+						bool bFacesAwayFromApex = IsPositiveTetrahedron(Apex, Others[0], Others[1], Others[2]);
+						bool bFlip = (bFacesAwayFromApex != (NumInside == 1));
+						int32 V0 = EdgeVertex(Cell, Apex, Others[0]);
+						int32 V1 = EdgeVertex(Cell, Apex, Others[1]);
+						int32 V2 = EdgeVertex(Cell, Apex, Others[2]);
+						if (bFlip)
+						{
+							AddTriangle(V0, V2, V1);
+						}
+						else
+						{
+							AddTriangle(V0, V1, V2);
+						}
+					}
+					else if (NumInside == 2)
+					{
+						// quad separating inside corners (A,B) from outside corners (C,D). For a positive
+						// tetrahedron (A,B,C,D) the quad (AC,AD,BD,BC) faces towards C and D.
+						int32 A = Inside[0], B = Inside[1], C = Outside[0], D = Outside[1];
+						bool bFlip = !IsPositiveTetrahedron(A, B, C, D);
+						int32 V0 = EdgeVertex(Cell, A, C);
+						int32 V1 = EdgeVertex(Cell, A, D);
+						int32 V2 = EdgeVertex(Cell, B, D);
+						int32 V3 = EdgeVertex(Cell, B, C);
+						if (bFlip)
+						{
+							AddTriangle(V0, V2, V1);
+							AddTriangle(V0, V3, V2);
+						}
+						else
+						{
+							AddTriangle(V0, V1, V2);
+							AddTriangle(V0, V2, V3);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+
+
+bool RTGUtils::ExtractSparseIsoSurface(
+	TFunctionRef<double(const FVector3d&)> Implicit,
+	TFunctionRef<bool(const FAxisAlignedBox3d&)> SeedBlockF,
+	const FAxisAlignedBox3d& Bounds,
+	double CellSize,
+	FDynamicMesh3& MeshOut,
+	int32 RootRefinementSteps,
+	int32 BlockSize,
+	TFunction<bool()> CancelF,
+	bool bCloseAtGridBorder)
+{
+	if (!ensure(CellSize > 0 && BlockSize > 0 && Bounds.IsEmpty() == false))
+	{
+		return true;
+	}
+
+	const FVector3d Origin = Bounds.Min;
+	const double BlockWidth = CellSize * (double)BlockSize;
+	FVector3i NumBlocks;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		NumBlocks[j] = FMath::Max(1, (int32)FMathd::Ceil((Bounds.Max[j] - Bounds.Min[j]) / BlockWidth));
+	}
+	const FVector3i NumSamples = NumBlocks * BlockSize + FVector3i(1, 1, 1);
+	const int32 TotalBlocks = NumBlocks.X * NumBlocks.Y * NumBlocks.Z;
+	auto BlockCoords = [&NumBlocks](int32 BlockID) { return FVector3i(BlockID % NumBlocks.X, (BlockID / NumBlocks.X) % NumBlocks.Y, BlockID / (NumBlocks.X * NumBlocks.Y)); };
+
+	// find the initial set of blocks
+	TArray<uint8> BlockQueued;
+	BlockQueued.SetNumZeroed(TotalBlocks);
+	ParallelFor(TotalBlocks, [&](int32 BlockID)
+	{
+		FVector3i Coords = BlockCoords(BlockID);
+		FVector3d BlockMin = Origin + BlockWidth * FVector3d((double)Coords.X, (double)Coords.Y, (double)Coords.Z);
+		BlockQueued[BlockID] = SeedBlockF(FAxisAlignedBox3d(BlockMin, BlockMin + BlockWidth * FVector3d::One())) ? 1 : 0;
+	});
+	TArray<int32> PendingBlocks;
+	for (int32 BlockID = 0; BlockID < TotalBlocks; ++BlockID)
+	{
+		if (BlockQueued[BlockID])
+		{
+			PendingBlocks.Add(BlockID);
+		}
+	}
+
+	// Process the blocks in waves. Each wave is evaluated in parallel, then merged into MeshOut, and the
+	// neighbours that the surface crosses into (and that have not been processed yet) form the next wave.
+	const FVector3i FaceNeighbours[6] = { FVector3i(-1,0,0), FVector3i(1,0,0), FVector3i(0,-1,0), FVector3i(0,1,0), FVector3i(0,0,-1), FVector3i(0,0,1) };
+	TMap<int64, int32> GlobalVertices;
+	FThreadSafeBool bCancelled = false;
+	while (PendingBlocks.Num() > 0)
+	{
+		TArray<FSparseBlockSurface> BlockSurfaces;
+		BlockSurfaces.SetNum(PendingBlocks.Num());
+		ParallelFor(PendingBlocks.Num(), [&](int32 k)
+		{
+			if (bCancelled || (CancelF && CancelF()))
+			{
+				bCancelled = true;
+				return;
+			}
+			ExtractBlockSurface(Implicit, Origin, CellSize, NumSamples,
+				BlockCoords(PendingBlocks[k]) * BlockSize, BlockSize, RootRefinementSteps, bCloseAtGridBorder, BlockSurfaces[k]);
+		});
+		if (bCancelled)
+		{
+			return false;
+		}
+
+		TArray<int32> NextBlocks;
+		for (int32 k = 0; k < PendingBlocks.Num(); ++k)
+		{
+			const FSparseBlockSurface& Surface = BlockSurfaces[k];
+			TArray<int32> VertexMap;
+			VertexMap.SetNum(Surface.Positions.Num());
+			for (int32 v = 0; v < Surface.Positions.Num(); ++v)
+			{
+				const int32* Found = GlobalVertices.Find(Surface.VertexKeys[v]);
+				if (Found != nullptr)
+				{
+					VertexMap[v] = *Found;
+				}
+				else
+				{
+					VertexMap[v] = MeshOut.AppendVertex(Surface.Positions[v]);
+					GlobalVertices.Add(Surface.VertexKeys[v], VertexMap[v]);
+				}
+			}
+			for (const FIndex3i& Tri : Surface.Triangles)
+			{
+				MeshOut.AppendTriangle(VertexMap[Tri.A], VertexMap[Tri.B], VertexMap[Tri.C]);
+			}
+
+			FVector3i Coords = BlockCoords(PendingBlocks[k]);
+			for (int32 Face = 0; Face < 6; ++Face)
+			{
+				FVector3i Nbr = Coords + FaceNeighbours[Face];
+				if ((Surface.CrossedFaces & (1 << Face)) != 0
+					&& Nbr.X >= 0 && Nbr.Y >= 0 && Nbr.Z >= 0 && Nbr.X < NumBlocks.X && Nbr.Y < NumBlocks.Y && Nbr.Z < NumBlocks.Z)
+				{
+					int32 NbrID = Nbr.X + NumBlocks.X * (Nbr.Y + NumBlocks.Y * Nbr.Z);
+					if (BlockQueued[NbrID] == 0)
+					{
+						BlockQueued[NbrID] = 1;
+						NextBlocks.Add(NbrID);
+					}
+				}
+			}
+		}
+
+		NextBlocks.Sort();
+		PendingBlocks = MoveTemp(NextBlocks);
+	}
+
+	return true;
+}
+
+
+
+void RTGUtils::ComputeSparseSolidify(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	int32 VoxelResolution,
+	double WindingThreshold,
+	double ExtendBounds,
+	FDynamicMesh3& ResultOut)
+{
+	FAxisAlignedBox3d MeshBounds = Spatial.GetBoundingBox();
+	double CellSize = FMathd::Max(MeshBounds.MaxDim() / (double)FMath::Max(VoxelResolution, 1), FMathf::ZeroTolerance);
+	FAxisAlignedBox3d GridBounds = MeshBounds;
+	GridBounds.Expand(FMathd::Max(ExtendBounds, 1.0) * CellSize);
+
+	// winding number is above the threshold inside
+	auto WindingField = [&Winding, WindingThreshold](const FVector3d& Pos)
+	{
+		return WindingThreshold - Winding.FastWindingNumber(Pos);
+	};
+
+	// seed with the blocks that contain part of the mesh surface
+	auto NearMeshSurface = [&Spatial, CellSize](const FAxisAlignedBox3d& BlockBounds)
+	{
+		IMeshSpatial::FQueryOptions QueryOptions;
+		QueryOptions.MaxDistance = 0.5 * BlockBounds.DiagonalLength() + CellSize;
+		double NearestDistSqr = 0;
+		return Spatial.FindNearestTriangle(BlockBounds.Center(), NearestDistSqr, QueryOptions) >= 0;
+	};
+
+	ResultOut = FDynamicMesh3();
+	ExtractSparseIsoSurface(WindingField, NearMeshSurface, GridBounds, CellSize, ResultOut, 3);
+}
+
+
+
+void RTGUtils::ComputeSparseOffset(
+	FDynamicMeshAABBTree3& Spatial,
+	TFastWindingTree<FDynamicMesh3>& Winding,
+	double OffsetDistance,
+	int32 VoxelResolution,
+	FDynamicMesh3& ResultOut,
+	double WindingThreshold)
+{
+	FAxisAlignedBox3d MeshBounds = Spatial.GetBoundingBox();
+	double Dilation = FMathd::Max(OffsetDistance, 0.0);
+	double CellSize = FMathd::Max((MeshBounds.MaxDim() + 2.0 * Dilation) / (double)FMath::Max(VoxelResolution, 1), FMathf::ZeroTolerance);
+	FAxisAlignedBox3d GridBounds = MeshBounds;
+	GridBounds.Expand(Dilation + 2.0 * CellSize);
+
+	// Only the sign of the field matters away from the offset surface, so distances are only sampled in a band around it.
+	// Any grid edge that crosses the offset surface has both samples within one cell diagonal of it.
+	const double BandWidth = 2.0 * CellSize * FMathd::Sqrt(3.0);
+	FSparseFieldGrid Grid;
+	Grid.Initialize(GridBounds, CellSize);
+	SampleSignedDistance(Spatial, Winding, Grid, BandWidth, WindingThreshold, OffsetDistance);
+
+	ResultOut = FDynamicMesh3();
+	ExtractIsoSurface(Grid, OffsetDistance, ResultOut);
+}
@@ -0,0 +1,85 @@
+#include "Misc/AutomationTest.h"
+
+#include "MeshBooleanRuntimeUtils.h"
+#include "Generators/SphereGenerator.h"
+#include "Generators/GridBoxMeshGenerator.h"
+#include "MeshTransforms.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Box of the given half-extent at the origin, with its AABBTree and FastWinding tree */
+struct FBooleanTestTarget
+{
+	FDynamicMesh3 Mesh;
+	FDynamicMeshAABBTree3 Spatial;
+	TUniquePtr<TFastWindingTree<FDynamicMesh3>> Winding;
+
+	FBooleanTestTarget(double HalfExtent)
+	{
+		FGridBoxMeshGenerator BoxGen;
+		BoxGen.EdgeVertices = FIndex3i(16, 16, 16);
+		BoxGen.Box = FOrientedBox3d(FVector3d::Zero(), HalfExtent * FVector3d::One());
+		Mesh.Copy(&BoxGen.Generate());
+		Spatial.SetMesh(&Mesh, true);
+		Winding = MakeUnique<TFastWindingTree<FDynamicMesh3>>(&Spatial);
+	}
+};
+
+static FDynamicMesh3 MakeTestSphere(double Radius)
+{
+	FSphereGenerator SphereGen;
+	SphereGen.NumPhi = SphereGen.NumTheta = 24;
+	SphereGen.Radius = Radius;
+	return FDynamicMesh3(&SphereGen.Generate());
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLocalizedBooleanLargeMeshTest, "RuntimeGeometryUtils.MeshBoolean.LocalizedBooleanLargeMesh",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLocalizedBooleanLargeMeshTest::RunTest(const FString& Parameters)
+{
+	// a mesh several hundred units across, so the weld tolerance must be scaled from the normalized units FMeshBoolean works in
+	FDynamicMesh3 Tool = MakeTestSphere(80.0);
+	FTransform3d ToolTransform(FVector3d(300.0, 40.0, -25.0));
+
+	for (FMeshBoolean::EBooleanOp Operation : { FMeshBoolean::EBooleanOp::Difference, FMeshBoolean::EBooleanOp::Union })
+	{
+		FBooleanTestTarget Result(300.0);
+		bool bOK = RTGUtils::ComputeLocalizedBoolean(Result.Mesh, Result.Spatial, *Result.Winding, Tool, ToolTransform, Operation);
+		TestTrue(TEXT("Localized Boolean succeeded"), bOK);
+		TestTrue(TEXT("Localized Boolean result has no boundary edges"), Result.Mesh.IsClosed());
+	}
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLocalizedBooleanContainedToolTest, "RuntimeGeometryUtils.MeshBoolean.LocalizedBooleanContainedTool",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLocalizedBooleanContainedToolTest::RunTest(const FString& Parameters)
+{
+	// the tool is inside the target without touching any target triangle
+	FDynamicMesh3 Tool = MakeTestSphere(20.0);
+	FTransform3d ToolTransform = FTransform3d::Identity();
+
+	FBooleanTestTarget UnionResult(300.0);
+	int32 TargetTriangleCount = UnionResult.Mesh.TriangleCount();
+	RTGUtils::ComputeLocalizedBoolean(UnionResult.Mesh, UnionResult.Spatial, *UnionResult.Winding, Tool, ToolTransform, FMeshBoolean::EBooleanOp::Union);
+	TestEqual(TEXT("Union with a contained tool does not modify the target"), UnionResult.Mesh.TriangleCount(), TargetTriangleCount);
+
+	FBooleanTestTarget DifferenceResult(300.0);
+	TArray<int32> NewTriangles;
+	RTGUtils::ComputeLocalizedBoolean(DifferenceResult.Mesh, DifferenceResult.Spatial, *DifferenceResult.Winding, Tool, ToolTransform,
+		FMeshBoolean::EBooleanOp::Difference, 0.1, nullptr, &NewTriangles);
+	TestEqual(TEXT("Difference with a contained tool adds a cavity"), NewTriangles.Num(), Tool.TriangleCount());
+	if (NewTriangles.Num() > 0)
+	{
+		// the cavity faces inwards, ie towards the center of the tool
+		int32 tid = NewTriangles[0];
+		TestTrue(TEXT("Cavity has reversed orientation"), DifferenceResult.Mesh.GetTriNormal(tid).Dot(DifferenceResult.Mesh.GetTriCentroid(tid)) < 0);
+	}
+	return true;
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include "DynamicMesh3.h"
 #include "DynamicMeshAABBTree3.h"
 #include "Spatial/FastWinding.h"
+#include "SimplificationLODChain.h"
+#include "ImportedMeshCache.h"
 #include "DynamicMeshBaseActor.generated.h"
 
 
@@ -54,6 +56,74 @@ enum class EDynamicMeshActorBooleanOperation : uint8
 };
 
 
+/**
+ * Boolean evaluation modes supported by ADynamicMeshBaseActor
+ */
+UENUM(BlueprintType)
+enum class EDynamicMeshActorBooleanMode : uint8
+{
+	/** Boolean is computed on the full SourceMesh */
+	Exact,
+	/** Boolean is only computed on the part of SourceMesh near the other mesh, and the result is stitched back into SourceMesh. Intersection falls back to Exact. */
+	ExactLocalRegion,
+	/** Approximate Boolean, the part of SourceMesh near the other mesh is voxelized with the other mesh and remeshed on a sparse voxel grid. Cost only depends on the voxel resolution. Intersection falls back to Exact. */
+	VoxelLocalRegion
+};
+
+/**
+ * Voxelization modes supported by ADynamicMeshBaseActor::SolidifyMesh()
+ */
+UENUM(BlueprintType)
+enum class EDynamicMeshActorSolidifyMode : uint8
+{
+	/** Winding number is sampled on the full voxel grid with TImplicitSolidify */
+	DenseGrid,
+	/** Winding number is only sampled in blocks of the voxel grid that the surface passes through, in parallel. Much faster at high resolutions. */
+	SparseGrid,
+	/** Winding number is sampled on the full voxel grid in parallel blocks with RTGUtils::SampleWindingNumber(), and the surface is extracted with marching tetrahedra */
+	BatchedDenseGrid
+};
+
+/**
+ * Offset modes supported by ADynamicMeshBaseActor::OffsetMesh()
+ */
+UENUM(BlueprintType)
+enum class EDynamicMeshActorOffsetMode : uint8
+{
+	/** Distance field is computed on the full voxel grid with TImplicitMorphology */
+	DenseGrid,
+	/** Distances are only computed in blocks of the voxel grid that the offset surface passes through, in parallel. Much faster and smaller at high resolutions. */
+	SparseNarrowBand,
+	/** Signed distance is sampled on the full voxel grid in parallel blocks with RTGUtils::SampleSignedDistance(), and the surface is extracted with marching tetrahedra */
+	BatchedDenseGrid
+};
+
+/**
+ * Simplification modes supported by ADynamicMeshBaseActor::SimplifyMeshToTriCount()
+ */
+UENUM(BlueprintType)
+enum class EDynamicMeshActorSimplifyMode : uint8
+{
+	/** QEM simplification of the full mesh on a single thread */
+	Serial,
+	/** Spatial patches of the mesh are simplified in parallel with locked borders, followed by a serial pass over the full mesh. Much faster for large meshes. */
+	ParallelPatches
+};
+
+/**
+ * Remeshing modes supported by ADynamicMeshBaseActor::RemeshMesh()
+ */
+UENUM(BlueprintType)
+enum class EDynamicMeshActorRemeshMode : uint8
+{
+	/** FQueueRemesher over the full mesh on a single thread */
+	Serial,
+	/** Spatial patches of the mesh are remeshed in parallel with locked borders, in two passes over shifted patch grids, followed by parallel smoothing. Much faster for large meshes. */
+	ParallelPatches
+};
+
+
+
 UENUM(BlueprintType)
 enum class EDynamicMeshActorCollisionMode : uint8
 {
@@ -82,11 +152,13 @@ enum class EDynamicMeshActorCollisionMode : uint8
  * system to work.
  *
  * A small set of mesh modification UFunctions are also available via Blueprints,
- * including BooleanWithMesh(), SolidifyMesh(), SimplifyMeshToTriCount(), and 
+ * including BooleanWithMesh(), BooleanWithMeshes(), SolidifyMesh(), SimplifyMeshToTriCount(), and 
  * CopyFromMesh().
  *
  * Meshes can be read from OBJ files either using the ImportedMesh type for
  * the SourceType property, or by calling the ImportMesh() UFunction from a Blueprint.
+ * With the ImportedMesh type, Actors with the same import settings share a single
+ * imported mesh and its spatial data structures until they are edited.
  * Note that calling this in a Construction Script will be problematic in the Editor
  * as the OBJ will be re-read any time the Actor is modified (including translated/rotated).
  *
@@ -185,6 +257,13 @@ public:
 	 */
 	virtual void EditMesh(TFunctionRef<void(FDynamicMesh3&)> EditFunc);
 
+	/**
+	 * Variant of EditMesh() for edits that only move existing vertices, ie that do not add/remove vertices or triangles
+	 * or modify the attribute overlay topology. Subclasses can then update their Component without rebuilding it.
+	 * @param bNormalsModified if false, EditFunc did not modify the normals overlay (eg for a uniform scaling), so the Component normals are not updated
+	 */
+	virtual void EditMeshPositions(TFunctionRef<void(FDynamicMesh3&)> EditFunc, bool bNormalsModified = true);
+
 	/**
 	 * Get a copy of the current SourceMesh stored in MeshOut
 	 */
@@ -195,6 +274,16 @@ public:
 	 */
 	virtual const FDynamicMesh3& GetMeshRef() const;
 
+	/**
+	 * @return the AABBTree for the current SourceMesh, or nullptr if it has not been built or is out-of-date
+	 */
+	virtual FDynamicMeshAABBTree3* GetCachedSpatial();
+
+	/**
+	 * @return the FastWinding tree for the current SourceMesh, or nullptr if it has not been built or is out-of-date
+	 */
+	virtual TFastWindingTree<FDynamicMesh3>* GetCachedFastWinding();
+
 
 	/**
 	 * This delegate is broadcast whenever the internal SourceMesh is updated
@@ -204,9 +293,30 @@ public:
 
 protected:
 
-	/** The SourceMesh used to initialize the mesh Components in the various subclasses */
+	/**
+	 * The SourceMesh used to initialize the mesh Components in the various subclasses. If SharedSourceMesh is set,
+	 * SourceMesh is empty and the shared mesh is used instead, so GetMeshRef() should be used to access the current mesh.
+	 */
 	FDynamicMesh3 SourceMesh;
 
+	/**
+	 * Imported mesh shared with the other Actors that have the same import settings. It is used as the SourceMesh
+	 * until the first EditMesh()/EditMeshPositions(), which replaces it with a private copy in SourceMesh.
+	 */
+	TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> SharedSourceMesh;
+
+	/** Replace SourceMesh with the shared imported mesh, and update the Components */
+	virtual void SetSharedSourceMesh(TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> SharedMesh);
+
+	/** If SourceMesh is shared, copy the shared mesh into SourceMesh and release it. Called before SourceMesh is edited. */
+	void ForkSharedSourceMesh();
+
+	/** Find the imported mesh for the current import settings in the imported mesh cache, or import it */
+	TSharedPtr<RTGUtils::FSharedImportedMesh, ESPMode::ThreadSafe> FindOrImportSharedMesh();
+
+	/** Read the OBJ file at ImportPath and apply the import settings and NormalsMode to it */
+	virtual void ImportSourceMesh(const FString& UsePath, FDynamicMesh3& MeshOut);
+
 	/** Accumulated time since Actor was created, this is used for the animated primitives when bRegenerateOnTick = true*/
 	double AccumulatedTime = 0;
 
@@ -219,6 +329,42 @@ protected:
 	/** Call this on a Mesh to compute normals according to the NormalsMode setting */
 	virtual void RecomputeNormals(FDynamicMesh3& MeshOut);
 
+	/**
+	 * Calls OnMeshGenerationSettingsModified(), unless SourceMesh is the primitive that the current settings would generate.
+	 * Used in PostLoad(), PostActorCreated() and BeginPlay() to avoid regenerating the same mesh several times during startup.
+	 */
+	virtual void RegenerateSourceMeshIfOutdated();
+
+	/** @return true if SourceMesh is an unmodified generated primitive, and the current settings would generate the same mesh topology */
+	bool IsGeneratedPrimitiveTopologyCurrent() const;
+
+	/** @return the current radius of the generated primitive, which varies over time if bRegenerateOnTick = true */
+	double GetPrimitiveRadius() const;
+
+	/**
+	 * If SourceMesh is the unmodified primitive generated by RegenerateSourceMesh(), and only the primitive radius has changed since then,
+	 * set the SourceMesh vertices to the unit-size template scaled to the new radius via EditMeshPositions(), instead of regenerating it.
+	 * Used by Tick() when bRegenerateOnTick = true.
+	 * @return false if the primitive has to be regenerated
+	 */
+	virtual bool RescaleGeneratedPrimitive();
+
+	/** Settings used to generate the current SourceMesh primitive, see RescaleGeneratedPrimitive() */
+	struct FGeneratedPrimitiveInfo
+	{
+		bool bValid = false;
+		EDynamicMeshActorPrimitiveType PrimitiveType;
+		EDynamicMeshActorNormalsMode NormalsMode;
+		int TessellationLevel;
+		float BoxDepthRatio;
+		double Radius;
+		/** unit-size template mesh that SourceMesh was copied from, with the same vertex IDs */
+		TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe> Template;
+		/** value of SourceMeshEditCount after the generation, if SourceMesh has been edited since then it is no longer the generated primitive */
+		int64 EditCount;
+	};
+	FGeneratedPrimitiveInfo GeneratedPrimitive;
+
 
 
 
@@ -233,11 +379,52 @@ public:
 	bool bEnableInsideQueries = false;
 
 protected:
-	// This AABBTree is updated each time SourceMesh is modified if bEnableSpatialQueries=true or bEnableInsideQueries=true
+	// This AABBTree is rebuilt on demand, by the first query after SourceMesh is modified, if bEnableSpatialQueries=true or bEnableInsideQueries=true
 	FDynamicMeshAABBTree3 MeshAABBTree;
-	// This FastWindingTree is updated each time SourceMesh is modified if bEnableInsideQueries=true
+	// This FastWindingTree is rebuilt on demand, by the first query after SourceMesh is modified, if bEnableInsideQueries=true
 	TUniquePtr<TFastWindingTree<FDynamicMesh3>> FastWinding;
 
+	/** @return the AABBTree of the current SourceMesh, ie of the shared mesh if SourceMesh is shared. It is not necessarily built. */
+	FDynamicMeshAABBTree3& GetSourceSpatial();
+	/** @return the FastWindingTree of the current SourceMesh, ie of the shared mesh if SourceMesh is shared. It is not necessarily built. */
+	TFastWindingTree<FDynamicMesh3>& GetSourceFastWinding();
+	/** Build the AABBTree, and the FastWindingTree if bBuildFastWinding, of the current SourceMesh if they are not up-to-date */
+	void BuildSourceSpatial(bool bBuildFastWinding = true);
+
+	// Compacted copy of SourceMesh and its AABBTree/FastWindingTree, for algorithms that do not support non-compact meshes.
+	// These are only created by GetCompactSpatial() if SourceMesh is not compact, and discarded each time SourceMesh is modified.
+	TUniquePtr<FDynamicMesh3> CompactSourceMesh;
+	TUniquePtr<FDynamicMeshAABBTree3> CompactMeshAABBTree;
+	TUniquePtr<TFastWindingTree<FDynamicMesh3>> CompactFastWinding;
+
+	/**
+	 * Get a compact version of SourceMesh with built AABBTree and FastWindingTree. If SourceMesh is compact, this is SourceMesh
+	 * and the regular MeshAABBTree/FastWinding, otherwise a compacted copy is cached until the next modification of SourceMesh.
+	 */
+	virtual void GetCompactSpatial(const FDynamicMesh3*& MeshOut, FDynamicMeshAABBTree3*& SpatialOut, TFastWindingTree<FDynamicMesh3>*& WindingOut);
+
+	// incremented each time SourceMesh is modified via EditMesh() or EditMeshPositions()
+	int64 SourceMeshEditCount = 0;
+	// values of SourceMeshEditCount when MeshAABBTree and FastWinding were last built, they are up-to-date if these match SourceMeshEditCount
+	int64 SpatialEditCount = -1;
+	int64 FastWindingEditCount = -1;
+
+	// update the cached data that depends on SourceMesh (ie the spatial data structures) after it has been modified
+	void UpdateSourceMeshCaches();
+
+	// Simplified LODs of SourceMesh created by SimplifyMeshToTriCount() if bCacheSimplificationLODs=true. The chain remains
+	// valid while SourceMesh is only modified by SimplifyMeshToTriCount(), ie while SimplifyLODChainEditCount == SourceMeshEditCount.
+	TUniquePtr<RTGUtils::FSimplificationLODChain> SimplifyLODChain;
+	int64 SimplifyLODChainEditCount = -1;
+
+	// Triangles of SourceMesh created by the last BooleanWithMesh()/BooleanWithMeshes() or RemeshEditedRegion() call, which
+	// RemeshEditedRegion() restricts remeshing to. Only valid while LastEditTrianglesEditCount == SourceMeshEditCount.
+	TArray<int32> LastEditTriangles;
+	int64 LastEditTrianglesEditCount = -1;
+
+	// set LastEditTriangles to the triangles created by the current edit of SourceMesh
+	void SetLastEditTriangles(TArray<int32>&& Triangles);
+
 
 	//
 	// Support for Runtime-Generated Collision
@@ -247,6 +434,50 @@ public:
 	EDynamicMeshActorCollisionMode CollisionMode = EDynamicMeshActorCollisionMode::NoCollision;
 
 
+	//
+	// Options for Mesh Modification API
+	//
+public:
+	/** How BooleanWithMesh() computes the Boolean. ExactLocalRegion is much faster for small cuts into large meshes, VoxelLocalRegion trades accuracy for a bounded cost per cut. */
+	UPROPERTY(EditAnywhere, Category = BooleanOptions)
+	EDynamicMeshActorBooleanMode BooleanMode = EDynamicMeshActorBooleanMode::Exact;
+
+	/** In the LocalRegion modes, the bounds of the other mesh are expanded by this fraction of their size to find the region of SourceMesh to process */
+	UPROPERTY(EditAnywhere, Category = BooleanOptions, meta = (UIMin = 0, UIMax = 1, EditCondition = "BooleanMode != EDynamicMeshActorBooleanMode::Exact", EditConditionHides))
+	float LocalRegionExpansion = 0.1;
+
+	/** In VoxelLocalRegion mode, number of voxels across the bounds of the other mesh */
+	UPROPERTY(EditAnywhere, Category = BooleanOptions, meta = (UIMin = 4, UIMax = 128, ClampMin = 4, ClampMax = 512, EditCondition = "BooleanMode == EDynamicMeshActorBooleanMode::VoxelLocalRegion", EditConditionHides))
+	int VoxelBooleanResolution = 32;
+
+	/** In VoxelLocalRegion mode, the Boolean is abandoned and SourceMesh is left unmodified if voxelization takes longer than this many seconds. The limit is checked between grid blocks, so it can be overrun slightly. Zero disables the limit. */
+	UPROPERTY(EditAnywhere, Category = BooleanOptions, meta = (UIMin = 0, UIMax = 0.1, ClampMin = 0, EditCondition = "BooleanMode == EDynamicMeshActorBooleanMode::VoxelLocalRegion", EditConditionHides))
+	float VoxelBooleanTimeBudget = 0.02;
+
+	/** How SolidifyMesh() voxelizes SourceMesh */
+	UPROPERTY(EditAnywhere, Category = SolidifyOptions)
+	EDynamicMeshActorSolidifyMode SolidifyMode = EDynamicMeshActorSolidifyMode::DenseGrid;
+
+	/** How OffsetMesh() computes the offset surface */
+	UPROPERTY(EditAnywhere, Category = OffsetOptions)
+	EDynamicMeshActorOffsetMode OffsetMode = EDynamicMeshActorOffsetMode::DenseGrid;
+
+	/** How SimplifyMeshToTriCount() simplifies SourceMesh */
+	UPROPERTY(EditAnywhere, Category = SimplifyOptions)
+	EDynamicMeshActorSimplifyMode SimplifyMode = EDynamicMeshActorSimplifyMode::Serial;
+
+	/**
+	 * If true, the first SimplifyMeshToTriCount() call builds a chain of simplified LODs of SourceMesh. Later calls start from the nearest LOD,
+	 * so they are much cheaper, and can also increase the triangle count again up to the original mesh. Any other modification of SourceMesh discards the LODs.
+	 */
+	UPROPERTY(EditAnywhere, Category = SimplifyOptions)
+	bool bCacheSimplificationLODs = false;
+
+	/** How RemeshMesh() remeshes SourceMesh */
+	UPROPERTY(EditAnywhere, Category = RemeshOptions)
+	EDynamicMeshActorRemeshMode RemeshMode = EDynamicMeshActorRemeshMode::Serial;
+
+
 	//
 	// ADynamicMeshBaseActor API that subclasses must implement.
 	//
@@ -257,6 +488,12 @@ protected:
 	 */
 	virtual void OnMeshEditedInternal();
 
+	/**
+	 * Called when the SourceMesh vertex positions (and normals if bNormalsModified) have been modified via EditMeshPositions().
+	 * Subclasses can override this to do a faster vertex-only update of their Component. The default implementation calls OnMeshEditedInternal().
+	 */
+	virtual void OnMeshPositionsEditedInternal(bool bNormalsModified);
+
 
 
 
@@ -326,6 +563,14 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool ContainsPoint(FVector WorldPoint, float WindingThreshold = 0.5);
 
+	/**
+	 * Sample the signed distance to SourceMesh (negative inside) on a grid in local space. The grid has VoxelResolution cells along the
+	 * largest dimension of the mesh bounds, which are extended by ExtendCells cells. Sample (i,j,k) is at GridOrigin + CellSize*(i,j,k),
+	 * and is stored at DistancesOut[i + Dimensions.X*(j + Dimensions.Y*k)].
+	 */
+	UFUNCTION(BlueprintCallable)
+	void SampleSignedDistanceGrid(int VoxelResolution, int ExtendCells, TArray<float>& DistancesOut, FVector& GridOrigin, float& CellSize, FIntVector& Dimensions, float WindingThreshold = 0.5);
+
 	/**
 	 * Calculate intersection of given 3D World-Space ray defined by (RayOrigin,RayDirection) with the SourceMesh.
 	 * If hit, returns WorldHitPoint position, distance along ray in HitDistance, NearestTriangle ID, and barycentric coordinates of hit point in triangle
@@ -346,6 +591,15 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void BooleanWithMesh(ADynamicMeshBaseActor* OtherMesh, EDynamicMeshActorBooleanOperation Operation);
 
+	/**
+	 * Compute the specified Boolean operation with all of OtherMeshes, and store in our SourceMesh. 
+	 * The OtherMeshes are first combined in parallel (with a Union, or an Intersection for the Intersection operation), 
+	 * and then a single Boolean is applied to SourceMesh, so the mesh is only updated once. If combining the OtherMeshes fails,
+	 * SourceMesh is not modified.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void BooleanWithMeshes(const TArray<ADynamicMeshBaseActor*>& OtherMeshes, EDynamicMeshActorBooleanOperation Operation);
+
 	/** Subtract OtherMesh from our SourceMesh */
 	UFUNCTION(BlueprintCallable)
 	void SubtractMesh(ADynamicMeshBaseActor* OtherMesh);
@@ -358,14 +612,37 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void IntersectWithMesh(ADynamicMeshBaseActor* OtherMesh);
 
-	/** Create a "solid" verison of SourceMesh by voxelizing with the fast winding number at the given grid resolution */
+	/** Create a "solid" verison of SourceMesh by voxelizing with the fast winding number at the given grid resolution. SolidifyMode selects dense, sparse or batched dense voxelization. */
 	UFUNCTION(BlueprintCallable)
 	void SolidifyMesh(int VoxelResolution = 64, float WindingThreshold = 0.5);
 
+	/** Replace SourceMesh with its offset surface at the given distance (positive dilates, negative erodes), computed on a voxel grid with the given resolution. OffsetMode selects dense, narrow-band sparse or batched dense voxelization. */
+	UFUNCTION(BlueprintCallable)
+	void OffsetMesh(float OffsetDistance, int VoxelResolution = 64);
+
 	/** Simplify current SourceMesh to the target triangle count */
 	UFUNCTION(BlueprintCallable)
 	void SimplifyMeshToTriCount(int32 TargetTriangleCount);
 
+	/** Isotropic remesh of current SourceMesh to the target edge length. RemeshMode selects serial or parallel remeshing. */
+	UFUNCTION(BlueprintCallable)
+	void RemeshMesh(float TargetEdgeLength, float SmoothingSpeed = 0.5);
+
+	/**
+	 * Remesh only the region of SourceMesh modified by the last Boolean, ie the triangles created by the Boolean expanded by ExpandRings rings
+	 * of neighbouring triangles, with the region border locked. Does nothing if SourceMesh has been modified in another way since the Boolean.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void RemeshEditedRegion(float TargetEdgeLength, int ExpandRings = 2, float SmoothingSpeed = 0.5);
+
+	/** Replace the UVs of SourceMesh with a conformal parameterization of charts whose normals deviate at most MaxChartNormalAngle degrees, packed into the unit square */
+	UFUNCTION(BlueprintCallable)
+	void GenerateChartUVs(float MaxChartNormalAngle = 60.0);
+
+protected:
+	/** Compute Boolean operation with OtherMesh, which is mapped to our local space by OtherToLocal. OtherSpatial is optional. */
+	virtual void BooleanWithMeshInternal(const FDynamicMesh3& OtherMesh, const FTransform3d& OtherToLocal, FDynamicMeshAABBTree3* OtherSpatial, EDynamicMeshActorBooleanOperation Operation);
+
 public:
 	/** @return number of triangles in current SourceMesh */
 	UFUNCTION(BlueprintCallable)
@@ -35,6 +35,7 @@ protected:
 	 * ADynamicBaseActor API
 	 */
 	virtual void OnMeshEditedInternal() override;
+	virtual void OnMeshPositionsEditedInternal(bool bNormalsModified) override;
 
 protected:
 	virtual void UpdateSDMCMesh();
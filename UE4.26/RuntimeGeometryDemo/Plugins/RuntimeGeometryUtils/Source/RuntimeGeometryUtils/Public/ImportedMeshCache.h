@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+#include "DynamicMeshAABBTree3.h"
+#include "Spatial/FastWinding.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Identifies an imported mesh by the file it was read from and the settings it was processed with. The file modification
+	 * time and size are part of the key, so that a file that is modified on disk is imported again instead of reusing the old mesh.
+	 */
+	struct FImportedMeshKey
+	{
+		/** full path of the source file */
+		FString Path;
+		FDateTime FileTimestamp;
+		int64 FileSize = 0;
+
+		bool bReverseOrientation = false;
+		bool bCenterPivot = false;
+		double ImportScale = 1.0;
+		/** normals mode applied to the imported mesh, eg EDynamicMeshActorNormalsMode */
+		int32 NormalsMode = 0;
+
+		bool operator==(const FImportedMeshKey& Other) const
+		{
+			return Path == Other.Path && FileTimestamp == Other.FileTimestamp && FileSize == Other.FileSize
+				&& bReverseOrientation == Other.bReverseOrientation && bCenterPivot == Other.bCenterPivot
+				&& ImportScale == Other.ImportScale && NormalsMode == Other.NormalsMode;
+		}
+	};
+
+	inline uint32 GetTypeHash(const FImportedMeshKey& Key)
+	{
+		uint32 Hash = HashCombine(::GetTypeHash(Key.Path), ::GetTypeHash(Key.FileTimestamp));
+		Hash = HashCombine(Hash, ::GetTypeHash(Key.FileSize));
+		Hash = HashCombine(Hash, ::GetTypeHash(Key.bReverseOrientation));
+		Hash = HashCombine(Hash, ::GetTypeHash(Key.bCenterPivot));
+		Hash = HashCombine(Hash, ::GetTypeHash(Key.ImportScale));
+		return HashCombine(Hash, ::GetTypeHash(Key.NormalsMode));
+	}
+
+
+	/**
+	 * An imported mesh that is shared by all users with the same FImportedMeshKey, along with its AABBTree and FastWindingTree.
+	 * The Mesh must not be modified after it has been added to the cache, users that need to edit it must make their own copy.
+	 * The spatial data structures are built on demand by BuildSpatial(), and can then be queried from any thread.
+	 */
+	struct RUNTIMEGEOMETRYUTILS_API FSharedImportedMesh
+	{
+		FDynamicMesh3 Mesh;
+		FDynamicMeshAABBTree3 AABBTree;
+		TFastWindingTree<FDynamicMesh3> FastWinding;
+
+		FSharedImportedMesh();
+
+		/** Build the AABBTree, and the FastWindingTree if bBuildFastWinding, unless they have already been built */
+		void BuildSpatial(bool bBuildFastWinding);
+
+	private:
+		FCriticalSection BuildLock;
+	};
+
+
+	/**
+	 * Find the shared mesh for Key in the process-wide imported mesh cache, or import it with ImportFunc and add it to the cache.
+	 * The cache does not keep the meshes alive, a mesh is deleted when the last reference returned by this function is released.
+	 * ImportFunc is called with the cache locked, so it must not call back into the cache.
+	 */
+	RUNTIMEGEOMETRYUTILS_API TSharedPtr<FSharedImportedMesh, ESPMode::ThreadSafe> FindOrAddImportedMesh(
+		const FImportedMeshKey& Key,
+		TFunctionRef<void(FDynamicMesh3&)> ImportFunc);
+}
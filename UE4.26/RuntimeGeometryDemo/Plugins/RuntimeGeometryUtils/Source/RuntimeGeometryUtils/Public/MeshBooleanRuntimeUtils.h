@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+#include "DynamicMeshAABBTree3.h"
+#include "Spatial/FastWinding.h"
+#include "Operations/MeshBoolean.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Find the triangles of Mesh whose bounding boxes intersect QueryBox, using the AABBTree of the mesh.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void FindTrianglesInBox(
+		const FDynamicMesh3& Mesh,
+		FDynamicMeshAABBTree3& Spatial,
+		const FAxisAlignedBox3d& QueryBox,
+		TArray<int32>& TrianglesOut);
+
+
+	/**
+	 * Compute a Boolean between TargetMesh and ToolMesh that only processes the part of TargetMesh near ToolMesh.
+	 * The triangles of TargetMesh that overlap the (expanded) bounds of ToolMesh are extracted into a submesh,
+	 * the Boolean is computed between that submesh and ToolMesh, and the result is stitched back into TargetMesh
+	 * along the region border. Only the boundary edges of the appended triangles and of the hole they fill are welded,
+	 * so the cost scales with the size of the cut, rather than the size of TargetMesh.
+	 *
+	 * Only Union and Difference are supported, as an Intersection modifies all of TargetMesh.
+	 *
+	 * @param TargetMesh mesh that is modified in-place
+	 * @param TargetSpatial AABBTree for TargetMesh, used to find the region triangles
+	 * @param TargetWinding FastWinding tree for TargetMesh, used to classify ToolMesh triangles against the full TargetMesh
+	 * @param ToolMesh second Boolean operand
+	 * @param ToolTransform maps ToolMesh into the local space of TargetMesh. ToolMesh is not copied or transformed, FMeshBoolean applies the transform internally.
+	 * @param Operation Union or Difference
+	 * @param RegionExpansion the bounds of ToolMesh are expanded by this fraction of their max dimension to find the region
+	 * @param ToolSpatial optional up-to-date AABBTree for ToolMesh, if available its cached bounds are used instead of iterating over ToolMesh
+	 * @param NewTrianglesOut optional list of the triangles added to TargetMesh
+	 * @return false if the Boolean or the welding failed, in which case TargetMesh may have cracks along the cut
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ComputeLocalizedBoolean(
+		FDynamicMesh3& TargetMesh,
+		FDynamicMeshAABBTree3& TargetSpatial,
+		TFastWindingTree<FDynamicMesh3>& TargetWinding,
+		const FDynamicMesh3& ToolMesh,
+		const FTransform3d& ToolTransform,
+		FMeshBoolean::EBooleanOp Operation,
+		double RegionExpansion = 0.1,
+		FDynamicMeshAABBTree3* ToolSpatial = nullptr,
+		TArray<int32>* NewTrianglesOut = nullptr);
+
+
+	/**
+	 * Approximate version of ComputeLocalizedBoolean(). The signed distance fields of TargetMesh and ToolMesh are combined with min/max
+	 * on a sparse voxel grid that only covers the region of TargetMesh near ToolMesh, and the surface of the combined field is extracted.
+	 * Distances and the inside/outside sign are only sampled in the grid blocks in a narrow band around the surfaces, and only these blocks are remeshed.
+	 * The region triangles of TargetMesh are then replaced with the extracted patch, which is zippered to the region border.
+	 * The cost depends on VoxelResolution and not on the complexity of the two meshes, and the Boolean cannot fail the way FMeshBoolean can,
+	 * but sharp edges along the cut are rounded off at the scale of the voxel size.
+	 * This is ComputeLocalizedVoxelBooleanPatch() followed by ApplyLocalizedVoxelBooleanPatch().
+	 *
+	 * @param VoxelResolution number of voxels across the bounds of ToolMesh
+	 * @param TimeBudgetSeconds time limit for the voxelization, see ComputeLocalizedVoxelBooleanPatch(). Zero or negative disables the limit.
+	 * @param NewTrianglesOut optional list of the triangles added to TargetMesh
+	 * @return false if the time budget was exceeded or the voxel grid would be too large, in which case TargetMesh is not modified
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ComputeLocalizedVoxelBoolean(
+		FDynamicMesh3& TargetMesh,
+		FDynamicMeshAABBTree3& TargetSpatial,
+		TFastWindingTree<FDynamicMesh3>& TargetWinding,
+		const FDynamicMesh3& ToolMesh,
+		const FTransform3d& ToolTransform,
+		FMeshBoolean::EBooleanOp Operation,
+		int32 VoxelResolution = 32,
+		double TimeBudgetSeconds = 0.0,
+		double RegionExpansion = 0.1,
+		TArray<int32>* NewTrianglesOut = nullptr);
+
+
+	/**
+	 * Result of ComputeLocalizedVoxelBooleanPatch(), the change to a target mesh made by a voxel Boolean.
+	 */
+	struct RUNTIMEGEOMETRYUTILS_API FLocalizedVoxelBooleanPatch
+	{
+		/** triangles of the target mesh that are replaced. If empty, the tool does not touch the target mesh and PatchMesh is appended without stitching. */
+		TArray<int32> RegionTriangles;
+		/** surface that replaces RegionTriangles, in the local space of the target mesh */
+		FDynamicMesh3 PatchMesh;
+	};
+
+	/**
+	 * Compute the voxel Boolean of ComputeLocalizedVoxelBoolean() without modifying TargetMesh. The expensive part of the Boolean
+	 * (sampling and surface extraction) only reads TargetMesh, so the result can be computed before deciding to edit the mesh.
+	 * TimeBudgetSeconds is checked between the blocks of the distance sampling of each mesh and of the surface extraction, so the
+	 * computation can overrun it by about one block per thread, plus the setup (copying the tool and building its trees).
+	 * @param PatchOut the patch to pass to ApplyLocalizedVoxelBooleanPatch(), its contents are undefined if this returns false
+	 * @return false if the time budget was exceeded or the voxel grid would be too large
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ComputeLocalizedVoxelBooleanPatch(
+		const FDynamicMesh3& TargetMesh,
+		FDynamicMeshAABBTree3& TargetSpatial,
+		TFastWindingTree<FDynamicMesh3>& TargetWinding,
+		const FDynamicMesh3& ToolMesh,
+		const FTransform3d& ToolTransform,
+		FMeshBoolean::EBooleanOp Operation,
+		FLocalizedVoxelBooleanPatch& PatchOut,
+		int32 VoxelResolution = 32,
+		double TimeBudgetSeconds = 0.0,
+		double RegionExpansion = 0.1);
+
+	/**
+	 * Replace the region triangles of TargetMesh with the patch computed by ComputeLocalizedVoxelBooleanPatch(), and zipper it to the region border.
+	 * TargetMesh must be the mesh the patch was computed for, or a copy of it with the same triangle IDs.
+	 * @param NewTrianglesOut optional list of the triangles added to TargetMesh
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ApplyLocalizedVoxelBooleanPatch(
+		FDynamicMesh3& TargetMesh,
+		const FLocalizedVoxelBooleanPatch& Patch,
+		TArray<int32>* NewTrianglesOut = nullptr);
+
+
+	/**
+	 * Fill the boundary loops of Mesh that contain a boundary edge of any of Triangles, using FMinimalHoleFiller.
+	 * This is used to repair the cracks left by a failed Boolean, without closing other open boundaries of Mesh.
+	 * If Mesh has a normals overlay, face normals are set on the fill triangles.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void FillHolesAroundTriangles(FDynamicMesh3& Mesh, const TArray<int32>& Triangles);
+
+
+	/**
+	 * Combine a set of meshes with the same Boolean operation, ie Meshes[0] op Meshes[1] op ... Meshes[N-1].
+	 * The meshes are combined pairwise as a tree reduction, and the Booleans at each level of the tree are computed in parallel.
+	 * @param Meshes input meshes, they are not modified or copied
+	 * @param Transforms per-mesh transforms into the space of ResultOut, must be the same length as Meshes
+	 * @param Operation should be Union or Intersect, as the reduction relies on the operation being associative
+	 * @param ResultOut combined mesh
+	 * @return false if any of the Booleans failed
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool CombineMeshesWithBoolean(
+		const TArray<const FDynamicMesh3*>& Meshes,
+		const TArray<FTransform3d>& Transforms,
+		FMeshBoolean::EBooleanOp Operation,
+		FDynamicMesh3& ResultOut);
+}
@@ -34,4 +34,17 @@ namespace RTGUtils
 		bool bInitializePerVertexColors,
 		bool bCreateCollision);
 
+
+	/**
+	 * Update the vertex positions (and optionally normals) of the section of a ProceduralMeshComponent that was initialized by
+	 * UpdatePMCFromDynamicMesh_SplitTriangles() with a mesh that had the same topology as Mesh. Only the vertex buffer is updated, the section is not recreated.
+	 * @param bUpdateNormals if true, normals are updated in the same way as UpdatePMCFromDynamicMesh_SplitTriangles(), otherwise the existing normals are kept
+	 * @return false if the section does not match Mesh, in which case nothing is updated
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool UpdatePMCPositionsFromDynamicMesh_SplitTriangles(
+		UProceduralMeshComponent* Component,
+		const FDynamicMesh3* Mesh,
+		bool bUpdateNormals,
+		bool bUseFaceNormals);
+
 }
\ No newline at end of file
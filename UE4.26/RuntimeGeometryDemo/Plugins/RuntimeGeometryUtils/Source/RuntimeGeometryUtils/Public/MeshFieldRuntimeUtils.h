@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+#include "DynamicMeshAABBTree3.h"
+#include "Spatial/FastWinding.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Dense grid of float samples. Sample (i,j,k) is at Origin + CellSize*(i,j,k), and is stored at Values[i + Dimensions.X*(j + Dimensions.Y*k)].
+	 */
+	struct RUNTIMEGEOMETRYUTILS_API FDenseFieldGrid
+	{
+		FVector3d Origin = FVector3d::Zero();
+		double CellSize = 1.0;
+		FVector3i Dimensions = FVector3i::Zero();
+		TArray<float> Values;
+
+		/** Set up the grid to cover Bounds with samples CellSizeIn apart, and allocate (but do not initialize) the values */
+		void Initialize(const FAxisAlignedBox3d& Bounds, double CellSizeIn);
+
+		int64 NumSamples() const { return (int64)Dimensions.X * (int64)Dimensions.Y * (int64)Dimensions.Z; }
+		int64 ToLinearIndex(const FVector3i& Index) const { return Index.X + (int64)Dimensions.X * (Index.Y + (int64)Dimensions.Y * Index.Z); }
+		FVector3d GetPosition(const FVector3i& Index) const { return Origin + CellSize * FVector3d((double)Index.X, (double)Index.Y, (double)Index.Z); }
+	};
+
+
+	/**
+	 * Sparse grid of float samples, with the same sample positions as FDenseFieldGrid, stored in blocks of BlockSize^3 samples.
+	 * Blocks that are not allocated have a single uniform value, so memory scales with the number of allocated blocks rather than the grid volume.
+	 */
+	struct RUNTIMEGEOMETRYUTILS_API FSparseFieldGrid
+	{
+		FVector3d Origin = FVector3d::Zero();
+		double CellSize = 1.0;
+		int32 BlockSize = 8;
+		// number of samples along each axis, a multiple of BlockSize
+		FVector3i Dimensions = FVector3i::Zero();
+		FVector3i NumBlocks = FVector3i::Zero();
+
+		// for each block, index into BlockValues, or -1 if the block is not allocated
+		TArray<int32> BlockDataIndex;
+		// for each block that is not allocated, the value of all of its samples
+		TArray<float> BlockUniformValue;
+		// samples of the allocated blocks, sample (i,j,k) of a block is at i + BlockSize*(j + BlockSize*k)
+		TArray<TArray<float>> BlockValues;
+
+		/** Set up the grid to cover Bounds with samples CellSizeIn apart, with all blocks unallocated and set to zero */
+		void Initialize(const FAxisAlignedBox3d& Bounds, double CellSizeIn, int32 BlockSizeIn = 8);
+
+		int32 TotalBlocks() const { return NumBlocks.X * NumBlocks.Y * NumBlocks.Z; }
+		int32 NumAllocatedBlocks() const { return BlockValues.Num(); }
+		FVector3i GetBlockCoords(int32 BlockID) const { return FVector3i(BlockID % NumBlocks.X, (BlockID / NumBlocks.X) % NumBlocks.Y, BlockID / (NumBlocks.X * NumBlocks.Y)); }
+		FVector3d GetPosition(const FVector3i& Index) const { return Origin + CellSize * FVector3d((double)Index.X, (double)Index.Y, (double)Index.Z); }
+
+		/** @return value of sample Index, which must be inside the grid */
+		float GetValue(const FVector3i& Index) const;
+	};
+
+
+	/**
+	 * Fill Grid (which must be initialized) with the signed distance to the mesh of Spatial, negative inside, with the inside determined by the fast winding number.
+	 * The grid is processed in parallel blocks of 8^3 samples. The distance at the center of each block bounds the nearest-triangle search
+	 * of its samples, and each sample bounds the search of the next one, so most queries only visit a few tree nodes. Blocks that
+	 * do not contain the surface take their sign from a single winding number evaluation.
+	 * @param Spatial AABBTree for the mesh, must be built
+	 * @param Winding FastWinding tree for the same mesh, must be built
+	 */
+	RUNTIMEGEOMETRYUTILS_API void SampleSignedDistance(
+		FDynamicMeshAABBTree3& Spatial,
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		FDenseFieldGrid& Grid,
+		double WindingThreshold = 0.5);
+
+
+	/**
+	 * Narrow-band version of SampleSignedDistance() for sparse grids. Only the blocks that contain signed distances within NarrowBandWidth of
+	 * BandCenter are allocated, and their samples are clamped to [BandCenter-NarrowBandWidth, BandCenter+NarrowBandWidth]. The other blocks
+	 * are set to the nearer end of that range. A non-zero BandCenter places the band around an offset surface rather than the mesh surface.
+	 * @param CancelF optional, checked once per block. If it returns true, the sampling stops and the values of Grid are incomplete.
+	 * @return false if the sampling was cancelled
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool SampleSignedDistance(
+		FDynamicMeshAABBTree3& Spatial,
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		FSparseFieldGrid& Grid,
+		double NarrowBandWidth,
+		double WindingThreshold = 0.5,
+		double BandCenter = 0.0,
+		TFunction<bool()> CancelF = nullptr);
+
+
+	/**
+	 * Fill Grid (which must be initialized) with the fast winding number of the mesh, in parallel
+	 */
+	RUNTIMEGEOMETRYUTILS_API void SampleWindingNumber(
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		FDenseFieldGrid& Grid);
+
+
+	/**
+	 * Extract the IsoValue isosurface of the samples of Grid (which must be below IsoValue inside) with ExtractSparseIsoSurface(), on a grid of
+	 * cells with the same origin and size. The blocks whose samples span IsoValue are used as seeds, and the field is evaluated by looking up the samples.
+	 * @param RefineFieldF optional field that Grid was sampled from. If set, it is evaluated to refine the surface vertices between the samples with RootRefinementSteps bisection steps.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ExtractIsoSurface(
+		const FDenseFieldGrid& Grid,
+		double IsoValue,
+		FDynamicMesh3& MeshOut,
+		TFunction<double(const FVector3d&)> RefineFieldF = nullptr,
+		int32 RootRefinementSteps = 0);
+
+
+	/**
+	 * Extract the IsoValue isosurface of the samples of Grid (which must be below IsoValue inside) with ExtractSparseIsoSurface().
+	 * Only the allocated blocks of Grid are searched for seeds, so IsoValue should be inside the range of the samples that the allocated blocks were sampled for.
+	 * @param CancelF optional, checked once per block. If it returns true, the extraction stops and MeshOut is incomplete.
+	 * @param bCloseAtGridBorder if false, the surface is left open where it leaves the grid
+	 * @return false if the extraction was cancelled
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ExtractIsoSurface(
+		const FSparseFieldGrid& Grid,
+		double IsoValue,
+		FDynamicMesh3& MeshOut,
+		TFunction<bool()> CancelF = nullptr,
+		bool bCloseAtGridBorder = true);
+
+
+	/**
+	 * Dense-grid solidify, ie the WindingThreshold isosurface of the fast winding number of the mesh. The winding number is sampled on the full grid
+	 * with SampleWindingNumber(), the surface is extracted with ExtractIsoSurface(), and its vertices are refined by evaluating the winding number.
+	 * @param Spatial AABBTree for the input mesh, must be built
+	 * @param Winding FastWinding tree for the input mesh, must be built
+	 * @param VoxelResolution number of grid cells along the largest dimension of the mesh bounds
+	 * @param ExtendBounds number of cells the mesh bounds are extended by
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeDenseSolidify(
+		FDynamicMeshAABBTree3& Spatial,
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		int32 VoxelResolution,
+		double WindingThreshold,
+		double ExtendBounds,
+		FDynamicMesh3& ResultOut);
+
+
+	/**
+	 * Dense-grid offset, ie the OffsetDistance isosurface of the signed distance to the mesh. The signed distance is sampled on the full grid
+	 * with SampleSignedDistance(), and the surface is extracted with ExtractIsoSurface().
+	 * @param Spatial AABBTree for the input mesh, must be built
+	 * @param Winding FastWinding tree for the input mesh, must be built
+	 * @param OffsetDistance positive values dilate the mesh, negative values erode it
+	 * @param VoxelResolution number of grid cells along the largest dimension of the offset mesh bounds
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeDenseOffset(
+		FDynamicMeshAABBTree3& Spatial,
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		double OffsetDistance,
+		int32 VoxelResolution,
+		FDynamicMesh3& ResultOut,
+		double WindingThreshold = 0.5);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Approximate geodesic distances on a mesh with the Heat Method [Crane et al. 2013].
+	 * Initialize() builds and factorizes the heat and Poisson systems of the mesh once. Each ComputeDistances() call then only needs
+	 * one back-substitution for each system, plus a parallel gradient/divergence pass, so repeated multi-source queries are cheap.
+	 * Only Neumann boundary conditions are used for the heat flow, so distances are less accurate close to open boundaries.
+	 * The data is a snapshot of the mesh, it must be re-initialized after the mesh is modified.
+	 * ComputeDistances() does not modify the data, so it can be called from several threads at the same time.
+	 */
+	class RUNTIMEGEOMETRYUTILS_API FHeatGeodesics
+	{
+	public:
+		FHeatGeodesics();
+		~FHeatGeodesics();
+
+		/**
+		 * Precompute and factorize the systems for Mesh, which may be non-compact.
+		 * @param TimeStepScale multiplier on the heat time step, which is the squared mean edge length. Larger values give smoother distances.
+		 *   On very dense meshes the heat can underflow to zero far from the sources, larger values also avoid that.
+		 * @return false if the factorization failed (eg for degenerate meshes)
+		 */
+		bool Initialize(const FDynamicMesh3& Mesh, double TimeStepScale = 1.0);
+
+		/** @return true if Initialize() succeeded */
+		bool IsInitialized() const;
+
+		/**
+		 * Compute the distance of each vertex to the nearest of the SourceVertices
+		 * @param DistancesOut distances indexed by vertex ID of the initialization mesh, unused IDs are set to zero
+		 * @return false if not initialized or no source vertex is valid
+		 */
+		bool ComputeDistances(const TArray<int32>& SourceVertices, TArray<double>& DistancesOut) const;
+
+	protected:
+		struct FSolverData;
+		TUniquePtr<FSolverData> Data;
+	};
+}
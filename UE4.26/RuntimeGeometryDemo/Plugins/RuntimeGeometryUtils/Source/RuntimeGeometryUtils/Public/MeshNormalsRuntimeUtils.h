@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+#include "DynamicMeshAttributeSet.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Compute the normals of all triangles of Mesh in parallel.
+	 * @param NormalsOut normals indexed by triangle ID, unused IDs are set to zero
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeTriangleNormals(
+		const FDynamicMesh3& Mesh,
+		TArray<FVector3d>& NormalsOut);
+
+
+	/**
+	 * Compute per-vertex normals of Mesh in parallel, with the same area/angle weighting as FMeshNormals::ComputeVertexNormals().
+	 * The triangle normals and angles are computed first, and then each vertex sums the values of its one-ring triangles,
+	 * so there are no write conflicts between threads and no per-thread accumulation buffers are needed.
+	 * @param NormalsOut normals indexed by vertex ID, unused IDs are set to zero
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeVertexNormals(
+		const FDynamicMesh3& Mesh,
+		TArray<FVector3d>& NormalsOut,
+		bool bWeightByArea = true,
+		bool bWeightByAngle = true);
+
+
+	/**
+	 * Parallel version of FMeshNormals::InitializeOverlayToPerVertexNormals(). Replaces the elements of NormalOverlay with one element per vertex, set to the vertex normal.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void InitializeOverlayToPerVertexNormals(FDynamicMeshNormalOverlay* NormalOverlay);
+
+
+	/**
+	 * Parallel version of FMeshNormals::InitializeOverlayToPerTriangleNormals(). Replaces the elements of NormalOverlay with one element per triangle, set to the triangle normal.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void InitializeOverlayToPerTriangleNormals(FDynamicMeshNormalOverlay* NormalOverlay);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+#include "MeshConstraints.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Partition the triangles of Mesh into spatial patches, using a grid of CellsPerAxis^3 cells over the bounds of Mesh.
+	 * Each triangle is assigned to the cell containing its centroid, and empty cells are skipped.
+	 * @param CellShift shift of the grid as a fraction of the cell size. A shift of 0.5 puts the cell borders of the unshifted grid in the middle of the cells,
+	 *   so a second pass over the shifted patches can process the regions that were locked along the borders of the first pass.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void PartitionMeshSpatially(
+		const FDynamicMesh3& Mesh,
+		int32 CellsPerAxis,
+		TArray<TArray<int32>>& PatchesOut,
+		double CellShift = 0.0);
+
+
+	/**
+	 * Apply ProcessFunc to each patch of Mesh in parallel, and replace the patches in Mesh with the results.
+	 * Each patch is extracted into a separate submesh, and the processed submeshes are welded back to the rest of Mesh
+	 * (and to each other) along the patch borders, by merging the copies of each border edge. Only the border edges are visited,
+	 * so the cost of welding does not depend on the size of Mesh. ProcessFunc must not modify the boundary of its submesh, eg by
+	 * passing MakePatchBoundaryConstraints() to the algorithm it applies, and must not remove or renumber the boundary vertices (eg by compacting it).
+	 *
+	 * @param Patches disjoint sets of triangles of Mesh
+	 * @param ProcessFunc called with the patch index and the submesh for that patch. Called in parallel, so it must be thread-safe.
+	 * @param NewTrianglesOut optional list of the triangles of the processed patches in Mesh
+	 * @param BorderVerticesOut optional list of the vertices of Mesh along the patch borders, after welding
+	 * @return false if some border edges could not be welded, in which case Mesh has cracks along them
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ProcessMeshPatchesInParallel(
+		FDynamicMesh3& Mesh,
+		const TArray<TArray<int32>>& Patches,
+		TFunctionRef<void(int32, FDynamicMesh3&)> ProcessFunc,
+		TArray<int32>* NewTrianglesOut = nullptr,
+		TArray<int32>* BorderVerticesOut = nullptr);
+
+
+	/**
+	 * @return constraints that lock the boundary edges and vertices of PatchMesh, so that it can be welded back into the mesh it was extracted from
+	 */
+	RUNTIMEGEOMETRYUTILS_API FMeshConstraints MakePatchBoundaryConstraints(const FDynamicMesh3& PatchMesh);
+
+
+	/**
+	 * Simplify Mesh to TargetTriangleCount with FQEMSimplification, in parallel. Mesh is partitioned into PatchesPerAxis^3 spatial patches,
+	 * and each patch is simplified independently (and in parallel) with its border locked. The border strips are then simplified in a
+	 * final serial pass over the whole mesh, which also reduces the mesh to exactly TargetTriangleCount.
+	 * The patches are simplified to slightly more than their share of TargetTriangleCount, so that the final pass can also re-balance
+	 * the triangle budget between patches, which keeps the result close to that of a fully serial simplification.
+	 * @return false if the simplified patches could not be welded back into Mesh, in which case Mesh has cracks along the patch borders
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ParallelSimplifyToTriangleCount(
+		FDynamicMesh3& Mesh,
+		int32 TargetTriangleCount,
+		int32 PatchesPerAxis = 4);
+
+
+	/**
+	 * Tangential uniform-Laplacian smoothing of the interior vertices of Mesh, computed as parallel Jacobi iterations.
+	 * Each iteration computes all new positions from the previous positions into a separate buffer, and then writes them back,
+	 * so vertices can be processed in any order without write conflicts. Boundary vertices are not moved.
+	 * @param Alpha fraction of the tangential offset to the one-ring centroid that is applied in each iteration, in range [0,1]
+	 * @param Vertices optional list of the vertices to smooth, if null all vertices are smoothed
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ParallelSmoothVertices(
+		FDynamicMesh3& Mesh,
+		double Alpha,
+		int32 Iterations,
+		const TArray<int32>* Vertices = nullptr);
+
+
+	/**
+	 * Isotropic remeshing of Mesh with FQueueRemesher, in parallel. Mesh is partitioned into PatchesPerAxis^3 spatial patches,
+	 * and the edge splits/collapses/flips and smoothing of each patch run independently (and in parallel) with the patch border locked.
+	 * A second parallel pass over patches of a grid shifted by half a cell then remeshes the strips along the borders of the first pass,
+	 * and a final parallel Jacobi smoothing pass relaxes the remaining seams, ie the vertices within two rings of the borders of the second pass.
+	 * Boundary edges of Mesh are preserved.
+	 * @return false if the remeshed patches could not be welded back into Mesh, in which case Mesh has cracks along the patch borders
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ParallelRemesh(
+		FDynamicMesh3& Mesh,
+		double TargetEdgeLength,
+		double SmoothSpeedT = 0.5,
+		int32 PatchesPerAxis = 4);
+
+
+	/**
+	 * Remesh the region of Mesh around Triangles with FQueueRemesher, leaving the rest of Mesh unmodified. The region is Triangles expanded
+	 * by ExpandRings rings of neighbouring triangles, and it is remeshed as a submesh with a locked border that is welded back into Mesh.
+	 * So the cost scales with the size of the region rather than the size of Mesh, eg to clean up the triangles created by a Boolean.
+	 * @param Triangles seed triangles of the region, invalid IDs are ignored
+	 * @param RegionTrianglesOut optional list of the triangles of the remeshed region in Mesh
+	 * @return false if the remeshed region could not be welded back into Mesh, in which case Mesh has cracks along the region border
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool RemeshRegion(
+		FDynamicMesh3& Mesh,
+		const TArray<int32>& Triangles,
+		double TargetEdgeLength,
+		int32 ExpandRings = 2,
+		double SmoothSpeedT = 0.5,
+		TArray<int32>* RegionTrianglesOut = nullptr);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Partition the triangles of Mesh into charts for UV parameterization. Each chart is grown from a seed triangle across edges,
+	 * as long as the triangle normals stay within MaxNormalDeviationDeg of the average normal of the chart.
+	 * The normal cone keeps the charts close to developable, and (for deviations below 90 degrees) prevents closed charts,
+	 * which cannot be flattened.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeUVCharts(
+		const FDynamicMesh3& Mesh,
+		double MaxNormalDeviationDeg,
+		TArray<TArray<int32>>& ChartsOut);
+
+
+	/**
+	 * Compute a Least-Squares Conformal Map [Levy et al. 2002] of a chart, ie a connected set of triangles of Mesh with a boundary.
+	 * Two distant boundary vertices are pinned, and the sparse system over the remaining chart vertices is solved directly,
+	 * so the cost only depends on the size of the chart. The UVs have the same scale as the 3D positions.
+	 * @param ChartVerticesOut vertex IDs of the chart
+	 * @param UVsOut UV of each vertex in ChartVerticesOut
+	 * @return false if the chart could not be parameterized (eg it has no boundary, or the system is singular)
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ComputeConformalChartUVs(
+		const FDynamicMesh3& Mesh,
+		const TArray<int32>& ChartTriangles,
+		TArray<int32>& ChartVerticesOut,
+		TArray<FVector2d>& UVsOut);
+
+
+	/**
+	 * Pack UV charts into the unit square, with shelf packing of the chart bounding boxes. Charts are rotated so that
+	 * they are wider than they are tall, and all charts are scaled uniformly so that their relative sizes are preserved.
+	 * @param ChartUVs UVs of each chart, updated in place
+	 * @param Gutter space between charts, as a fraction of the UV square
+	 */
+	RUNTIMEGEOMETRYUTILS_API void PackUVCharts(
+		TArray<TArray<FVector2d>>& ChartUVs,
+		double Gutter = 0.005);
+
+
+	/**
+	 * Replace the primary UV overlay of Mesh (attributes are enabled if necessary) with a new parameterization.
+	 * Mesh is partitioned with ComputeUVCharts(), a conformal map of each chart is computed with ComputeConformalChartUVs() in parallel
+	 * over the charts, and the charts are packed with PackUVCharts(). Charts that cannot be mapped are projected onto the plane of their average normal.
+	 * Since each chart only needs a small sparse solve, the cost is roughly linear in the mesh size and scales with the number of cores.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeChartUVs(
+		FDynamicMesh3& Mesh,
+		double MaxNormalDeviationDeg = 60.0,
+		double Gutter = 0.005);
+}
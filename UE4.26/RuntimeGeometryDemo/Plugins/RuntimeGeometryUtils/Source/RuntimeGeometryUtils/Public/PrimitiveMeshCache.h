@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Identifies a generated primitive template mesh. Templates are generated at unit size, so the Extents are normalized
+	 * (eg (1,1,DepthRatio) for a box) and instances are created by copying and scaling the template.
+	 */
+	struct FPrimitiveTemplateKey
+	{
+		int32 PrimitiveType = 0;
+		int32 TessellationLevel = 0;
+		FVector3d Extents = FVector3d::One();
+
+		bool operator==(const FPrimitiveTemplateKey& Other) const
+		{
+			return PrimitiveType == Other.PrimitiveType && TessellationLevel == Other.TessellationLevel && Extents == Other.Extents;
+		}
+	};
+
+	inline uint32 GetTypeHash(const FPrimitiveTemplateKey& Key)
+	{
+		uint32 Hash = HashCombine(::GetTypeHash(Key.PrimitiveType), ::GetTypeHash(Key.TessellationLevel));
+		Hash = HashCombine(Hash, ::GetTypeHash(Key.Extents.X));
+		Hash = HashCombine(Hash, ::GetTypeHash(Key.Extents.Y));
+		return HashCombine(Hash, ::GetTypeHash(Key.Extents.Z));
+	}
+
+
+	/**
+	 * Find the template mesh for Key in the process-wide primitive cache, or generate it with GenerateFunc and add it to the cache.
+	 * Templates are never modified after they are added, so the returned mesh can be shared, and copied from any thread.
+	 * GenerateFunc is called with the cache locked, so it must not call back into the cache.
+	 */
+	RUNTIMEGEOMETRYUTILS_API TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe> FindOrAddPrimitiveTemplate(
+		const FPrimitiveTemplateKey& Key,
+		TFunctionRef<void(FDynamicMesh3&)> GenerateFunc);
+
+
+	/**
+	 * Remove all templates from the primitive cache. Meshes that are still referenced elsewhere are not deleted until they are released.
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ClearPrimitiveTemplates();
+}
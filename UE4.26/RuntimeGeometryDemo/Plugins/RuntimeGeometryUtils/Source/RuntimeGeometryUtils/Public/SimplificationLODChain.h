@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Chain of progressively simplified versions of a mesh, used to quickly produce a simplification to any triangle count.
+	 * Build() stores the full-resolution mesh, and then simplifies it repeatedly by LevelRatio, each level starting from the previous one,
+	 * so building the chain costs about as much as a single simplification of the full mesh.
+	 * GetMesh() then starts from the coarsest level that still has at least the requested number of triangles, so the cost of a request
+	 * is proportional to the size of the result rather than the size of the full mesh, and requests can go back up to the full resolution.
+	 */
+	class RUNTIMEGEOMETRYUTILS_API FSimplificationLODChain
+	{
+	public:
+		/** function that simplifies the given mesh to the given triangle count */
+		typedef TFunctionRef<void(FDynamicMesh3&, int32)> FSimplifyFunc;
+
+		/**
+		 * Build the chain of levels for BaseMesh
+		 * @param LevelRatio triangle count ratio between consecutive levels
+		 * @param MinTriangleCount levels are generated until they would have fewer triangles than this
+		 */
+		void Build(const FDynamicMesh3& BaseMesh, FSimplifyFunc SimplifyFunc, double LevelRatio = 0.5, int32 MinTriangleCount = 100);
+
+		/** @return true if Build() has been called */
+		bool IsBuilt() const { return Levels.Num() > 0; }
+
+		/** @return number of triangles of the full-resolution mesh */
+		int32 GetBaseTriangleCount() const;
+
+		/** Produce a simplification of the base mesh with TargetTriangleCount triangles (or the base mesh itself if it has fewer triangles) */
+		void GetMesh(int32 TargetTriangleCount, FSimplifyFunc SimplifyFunc, FDynamicMesh3& MeshOut) const;
+
+		/** discard all levels */
+		void Reset() { Levels.Reset(); }
+
+	protected:
+		/** levels with decreasing triangle counts, Levels[0] is the full-resolution mesh */
+		TArray<TUniquePtr<FDynamicMesh3>> Levels;
+	};
+}
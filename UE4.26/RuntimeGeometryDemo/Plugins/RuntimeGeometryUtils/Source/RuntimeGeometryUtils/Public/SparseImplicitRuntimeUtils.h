@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh3.h"
+#include "DynamicMeshAABBTree3.h"
+#include "Spatial/FastWinding.h"
+
+namespace RTGUtils
+{
+	/**
+	 * Extract the surface Implicit(P) = 0 of a scalar field (negative inside) on a sparse grid of cubic cells.
+	 * The grid is divided into blocks of BlockSize^3 cells. Only the blocks accepted by SeedBlockF, and the blocks that the
+	 * surface crosses into from an already-processed block, are evaluated, so the cost scales with the surface area rather than the grid volume.
+	 * Blocks are evaluated in parallel, and each cell is triangulated with marching tetrahedra. Vertices are identified by their grid edge,
+	 * so they are shared between neighbouring cells and blocks.
+	 *
+	 * @param Implicit scalar field, called in parallel so it must be thread-safe
+	 * @param SeedBlockF returns true for the blocks (given by their bounds) that may contain the surface, called in parallel for all blocks in the grid
+	 * @param Bounds region to sample, it is extended to a whole number of blocks
+	 * @param CellSize size of the grid cells
+	 * @param MeshOut extracted surface is appended to this mesh
+	 * @param RootRefinementSteps number of bisection steps used to locate each surface vertex on its grid edge, zero uses linear interpolation of the samples
+	 * @param BlockSize number of cells along each axis of a block
+	 * @param CancelF optional, checked once per block. If it returns true, the extraction stops and MeshOut is incomplete.
+	 * @param bCloseAtGridBorder if true, samples on the outer layer of the grid are treated as outside, so the surface is closed. Otherwise the surface is open where it leaves the grid.
+	 * @return false if the extraction was cancelled
+	 */
+	RUNTIMEGEOMETRYUTILS_API bool ExtractSparseIsoSurface(
+		TFunctionRef<double(const FVector3d&)> Implicit,
+		TFunctionRef<bool(const FAxisAlignedBox3d&)> SeedBlockF,
+		const FAxisAlignedBox3d& Bounds,
+		double CellSize,
+		FDynamicMesh3& MeshOut,
+		int32 RootRefinementSteps = 0,
+		int32 BlockSize = 8,
+		TFunction<bool()> CancelF = nullptr,
+		bool bCloseAtGridBorder = true);
+
+
+	/**
+	 * Sparse-grid alternative to TImplicitSolidify. The WindingThreshold isosurface of the fast winding number of the mesh is extracted
+	 * with ExtractSparseIsoSurface(), seeded with the blocks near the mesh surface. The isosurface spans holes in the mesh, the blocks
+	 * it passes through are found by following the surface from the seed blocks. This makes resolutions of 512 and above practical.
+	 *
+	 * @param Spatial AABBTree for the input mesh, must be built
+	 * @param Winding FastWinding tree for the input mesh, must be built
+	 * @param VoxelResolution number of grid cells along the largest dimension of the mesh bounds
+	 * @param WindingThreshold winding number isovalue
+	 * @param ExtendBounds number of cells the mesh bounds are extended by
+	 * @param ResultOut solid mesh is stored here
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeSparseSolidify(
+		FDynamicMeshAABBTree3& Spatial,
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		int32 VoxelResolution,
+		double WindingThreshold,
+		double ExtendBounds,
+		FDynamicMesh3& ResultOut);
+
+
+	/**
+	 * Narrow-band sparse alternative to TImplicitMorphology. The signed distance to the mesh (sign from the fast winding number) is sampled
+	 * on an FSparseFieldGrid with SampleSignedDistance(), which only allocates the blocks in a narrow band around the offset surface, and the
+	 * OffsetDistance isosurface is extracted from the allocated blocks with ExtractIsoSurface(). Memory scales with the area of the offset surface.
+	 *
+	 * @param Spatial AABBTree for the input mesh, must be built
+	 * @param Winding FastWinding tree for the input mesh, must be built
+	 * @param OffsetDistance positive values dilate the mesh, negative values erode it
+	 * @param VoxelResolution number of grid cells along the largest dimension of the offset mesh bounds
+	 * @param ResultOut offset mesh is stored here
+	 */
+	RUNTIMEGEOMETRYUTILS_API void ComputeSparseOffset(
+		FDynamicMeshAABBTree3& Spatial,
+		TFastWindingTree<FDynamicMesh3>& Winding,
+		double OffsetDistance,
+		int32 VoxelResolution,
+		FDynamicMesh3& ResultOut,
+		double WindingThreshold = 0.5);
+}
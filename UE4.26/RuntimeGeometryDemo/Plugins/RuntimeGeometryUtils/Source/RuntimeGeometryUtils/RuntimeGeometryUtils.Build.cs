@@ -49,6 +49,10 @@ public class RuntimeGeometryUtils : ModuleRules
 			);
 		
 		
+		// sparse Cholesky solvers used by FHeatGeodesics and ComputeConformalChartUVs
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "Eigen");
+
+
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{